@@ -20,8 +20,17 @@
  */
 
 #include "TChain.h"
+#include "TTree.h"
+#include "TBranch.h"
 #include "TH1F.h"
 #include "TList.h"
+#include "TEntryList.h"
+#include "TObjString.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TParameter.h"
+#include "TSystem.h"
+#include "TTimeStamp.h"
 #include "AliAnalysisTask.h"
 #include "AliTriggerAnalysis.h"
 #include "AliAnalysisManager.h"
@@ -30,12 +39,28 @@
 
 #include "AliMCEvent.h"
 #include "AliStack.h"
+#include "AliMCParticle.h"
+#include "AliTrackReference.h"
 #include "AliESDtrack.h"
 #include "AliESDtrackCuts.h"
 #include "AliMultiplicitySelectionCP.h"
 
 #include "AliCEPBase.h"
 #include "AliCEPUtils.h"
+// the AliMCInfo helpers below use C++11 (std::atomic, thread_local,
+// lambdas, <chrono>), the task therefore needs ROOT 6
+#if __cplusplus < 201103L
+#error "AliAnalysisTaskMCInfo needs C++11 (ROOT 6)"
+#endif
+#include "AliMCInfoFastOR.h"
+#include "AliMCInfoCutPipeline.h"
+#include "AliMCInfoEventBuffers.h"
+#include "AliMCInfoTruthIndex.h"
+#include "AliMCInfoHistShards.h"
+#include "AliMCInfoPDGCounter.h"
+#include "AliMCInfoTriggerCache.h"
+#include "AliMCInfoSkim.h"
+#include "AliMCInfoStageTimer.h"
 #include "AliAnalysisTaskMCInfo.h"
 
 class AliAnalysisTaskMCInfo;    // your analysis class
@@ -48,16 +73,50 @@ AliAnalysisTaskMCInfo::AliAnalysisTaskMCInfo()
   : AliAnalysisTaskSE()
   , fESD(0)
   , fTrigger(0)
+  , fCEPUtil(0)
+  , fCuts(0)
   , fTrackStatus(0)
   , fTracks(0)
+  , fBuffers(0)
+  , fTruth(0)
+  , fTTPassed(0)
+  , fFOEvaluated(kFALSE)
+  , fSTGMask(0)
   , fAnalysisStatus(AliCEPBase::kBitConfigurationSet)
   , fTTmask(AliCEPBase::kTTBaseLine)
   , fTTpattern(AliCEPBase::kTTBaseLine) 
+  , fTTmasks()
+  , fTTpatterns()
+  , fAdaptiveCuts(kFALSE)
+  , fNHistShards(1)
+  , fEventIndexSlot(0)
+  , fEventIndexHash()
+  , fSkimSlot(0)
+  , fRequiredBranches()
+  , fLateBranches()
+  , fTwoPhaseRead(kFALSE)
+  , fCheckpointFile()
+  , fCheckpointEvents(0)
+  , fCheckpointSeconds(0)
+  , fResume(kFALSE)
+  , fNEventsCheckpoint(0)
+  , fTimeCheckpoint(0)
   , fOutList(0)
+  , fHists(0)
+  , fTimer(0)
+  , fCutFlow(0)
+  , fTTAccepted(0)
+  , fTriggerCache(0)
+  , fSkipped(0)
+  , fBufferAllocations(0)
+  , fSkipWarned(0)
+  , fEventIndex(0)
+  , fSkim(0)
+  , fSkimTree(0)
   , fGammaE(0)
-  , fNeutralPDG(0)
-  , fEmcalHitMothers(0)
 {
+    for (Int_t ii=0; ii<4; ii++) fNFiredChips[ii] = 0;
+    for (Int_t ii=0; ii<kMaxTTConfigs; ii++) fNeutralPDG[ii] = fEmcalHitMothers[ii] = 0x0;
     // default constructor, don't allocate memory here!
     // this is used by root for IO purposes, it needs to remain empty
 }
@@ -68,17 +127,57 @@ AliAnalysisTaskMCInfo::AliAnalysisTaskMCInfo(const char* name,
   : AliAnalysisTaskSE(name)
   , fESD(0)
   , fTrigger(0)
+  , fCEPUtil(0)
+  , fCuts(0)
   , fTrackStatus(0)
   , fTracks(0)
+  , fBuffers(0)
+  , fTruth(0)
+  , fTTPassed(0)
+  , fFOEvaluated(kFALSE)
+  , fSTGMask(0)
   , fAnalysisStatus(state)
   , fTTmask(TTmask)
   , fTTpattern(TTpattern)
+  , fTTmasks()
+  , fTTpatterns()
+  , fAdaptiveCuts(kFALSE)
+  , fNHistShards(1)
+  , fEventIndexSlot(0)
+  , fEventIndexHash()
+  , fSkimSlot(0)
+  , fRequiredBranches()
+  , fLateBranches()
+  , fTwoPhaseRead(kFALSE)
+  , fCheckpointFile()
+  , fCheckpointEvents(0)
+  , fCheckpointSeconds(0)
+  , fResume(kFALSE)
+  , fNEventsCheckpoint(0)
+  , fTimeCheckpoint(0)
   , fOutList(0)
+  , fHists(0)
+  , fTimer(0)
+  , fCutFlow(0)
+  , fTTAccepted(0)
+  , fTriggerCache(0)
+  , fSkipped(0)
+  , fBufferAllocations(0)
+  , fSkipWarned(0)
+  , fEventIndex(0)
+  , fSkim(0)
+  , fSkimTree(0)
   , fGammaE(0)
-  , fNeutralPDG(0)
-  , fEmcalHitMothers(0)
 {
     // constructor
+    for (Int_t ii=0; ii<4; ii++) fNFiredChips[ii] = 0;
+    for (Int_t ii=0; ii<kMaxTTConfigs; ii++) fNeutralPDG[ii] = fEmcalHitMothers[ii] = 0x0;
+    // ESD branches used by the physics selection, the event selection and
+    // the track analysis
+    fRequiredBranches = "AliESDRun AliESDHeader AliMultiplicity AliESDVZERO AliESDAD "
+                        "AliESDZDC AliESDTZERO AliESDFMD "
+                        "SPDVertex SPDPileupVertices PrimaryVertex TPCVertex Tracks V0s";
+    fLateBranches = "Tracks";
     DefineInput(0, TChain::Class());    // define the input of the analysis: 
                                         // in this case we take a 'chain' of events
                                         // this chain is created by the analysis manager, 
@@ -92,18 +191,46 @@ AliAnalysisTaskMCInfo::AliAnalysisTaskMCInfo(const char* name,
 AliAnalysisTaskMCInfo::~AliAnalysisTaskMCInfo()
 {
     // destructor
-    if(fOutputList) {
-        delete fOutputList;     // at the end of your task, 
+    if(fOutList) {
+        delete fOutList;        // at the end of your task, 
                                 // it is deleted from memory by calling this function
     }
     if (fTrigger) {
         delete fTrigger;
         fTrigger = 0x0;
     }
+    if (fCEPUtil) {
+        delete fCEPUtil;
+        fCEPUtil = 0x0;
+    }
+    if (fCuts) {
+        delete fCuts;
+        fCuts = 0x0;
+    }
     if (fTrackStatus) {
         delete fTrackStatus;
         fTrackStatus = 0x0;
     }
+    if (fBuffers) {
+        delete fBuffers;
+        fBuffers = 0x0;
+    }
+    if (fTruth) {
+        delete fTruth;
+        fTruth = 0x0;
+    }
+    if (fHists) {
+        delete fHists;
+        fHists = 0x0;
+    }
+    if (fSkim) {
+        delete fSkim;
+        fSkim = 0x0;
+    }
+    if (fTimer) {
+        delete fTimer;
+        fTimer = 0x0;
+    }
     if (fTracks) {
         fTracks->SetOwner(kTRUE);
         fTracks->Clear();
@@ -112,6 +239,262 @@ AliAnalysisTaskMCInfo::~AliAnalysisTaskMCInfo()
     }
 
 
+}
+//_____________________________________________________________________________
+void AliAnalysisTaskMCInfo::AddTTConfig(UInt_t TTmask, UInt_t TTpattern)
+{
+    // add a track-cut configuration, must be called before the analysis starts.
+    // the configurations are bits of fTTPassed and index the arrays of size
+    // kMaxTTConfigs, the one of the constructor included
+    if (GetNTTConfigs()>=kMaxTTConfigs) {
+        printf("<E> At most %i track-cut configurations!\n", kMaxTTConfigs);
+        return;
+    }
+    Int_t n = fTTmasks.GetSize();
+    fTTmasks.Set(n+1);
+    fTTpatterns.Set(n+1);
+    fTTmasks[n] = TTmask;
+    fTTpatterns[n] = TTpattern;
+}
+//_____________________________________________________________________________
+Int_t AliAnalysisTaskMCInfo::SetWriteEventIndex(TChain* chain)
+{
+    // define the output slot of the event index, the caller connects it
+    fEventIndexHash = GetEventIndexHash(chain);
+    if (!fEventIndexSlot) {
+        fEventIndexSlot = GetNoutputs();
+        DefineOutput(fEventIndexSlot, TEntryList::Class());
+    }
+    return fEventIndexSlot;
+}
+//_____________________________________________________________________________
+Int_t AliAnalysisTaskMCInfo::SetWriteSkim()
+{
+    // define the output slot of the skim tree, the caller connects it
+    if (!fSkimSlot) {
+        fSkimSlot = GetNoutputs();
+        DefineOutput(fSkimSlot, TTree::Class());
+    }
+    return fSkimSlot;
+}
+//_____________________________________________________________________________
+void AliAnalysisTaskMCInfo::AddRequiredBranch(const char* branch)
+{
+    // e.g. for detectors needed by the physics selection
+    fRequiredBranches += " ";
+    fRequiredBranches += branch;
+}
+//_____________________________________________________________________________
+TString AliAnalysisTaskMCInfo::GetActiveBranches() const
+{
+    // the branches to be switched on in the input handler, separated by
+    // blanks; every name matches the branch and its sub-branches
+    TString active;
+    TObjArray* required = fRequiredBranches.Tokenize(" ");
+    TObjArray* late = fLateBranches.Tokenize(" ");
+    for (Int_t ii=0; ii<required->GetEntriesFast(); ii++) {
+        TString branch = ((TObjString*)required->At(ii))->GetString();
+        if (fTwoPhaseRead && late->FindObject(branch.Data())) continue;
+        active += branch + "* ";
+    }
+    delete required;
+    delete late;
+    return active.Strip(TString::kTrailing);
+}
+//_____________________________________________________________________________
+void AliAnalysisTaskMCInfo::LoadLateBranches()
+{
+    // second read phase: the switched-off track branches of the current entry
+    AliAnalysisManager* mgr = AliAnalysisManager::GetAnalysisManager();
+    TTree* tree = mgr->GetTree() ? mgr->GetTree()->GetTree() : 0x0;
+    if (!tree) return;
+    Long64_t entry = mgr->GetCurrentEntry();
+    TObjArray* late = fLateBranches.Tokenize(" ");
+    for (Int_t ii=0; ii<late->GetEntriesFast(); ii++) {
+        TBranch* branch = tree->GetBranch(((TObjString*)late->At(ii))->GetString().Data());
+        // getall=1 also reads a branch which is switched off
+        if (branch) branch->GetEntry(entry, 1);
+    }
+    delete late;
+    fESD->ConnectTracks();
+}
+//_____________________________________________________________________________
+TString AliAnalysisTaskMCInfo::GetConfigHash() const
+{
+    // an event index can only be reused with the same hash
+    TString config = Form("v%i;state=%ld;trigger=%u;tt=", kEventSelectionVersion,
+        fAnalysisStatus, (UInt_t)fOfflineTriggerMask);
+    for (Int_t cfg=0; cfg<GetNTTConfigs(); cfg++)
+        config += Form("%u:%u,", GetTTmask(cfg), GetTTpattern(cfg));
+    return TString::Format("%08x", config.Hash());
+}
+//_____________________________________________________________________________
+TString AliAnalysisTaskMCInfo::GetEventIndexHash(TChain* chain) const
+{
+    // an added, removed or rewritten file changes the entries of the chain,
+    // the index is then rebuilt instead of selecting the wrong events
+    TString input = GetConfigHash() + ";files=";
+    if (chain) {
+        // GetEntries fills the tree offsets
+        chain->GetEntries();
+        TObjArray* files = chain->GetListOfFiles();
+        for (Int_t ii=0; ii<files->GetEntriesFast(); ii++) {
+            input += Form("%s:%lld,", files->At(ii)->GetTitle(),
+                chain->GetTreeOffset()[ii+1] - chain->GetTreeOffset()[ii]);
+        }
+    }
+    return TString::Format("%08x", input.Hash());
+}
+//_____________________________________________________________________________
+void AliAnalysisTaskMCInfo::SetCheckpoint(const char* file, Long64_t nEvents, Double_t seconds)
+{
+    // a limit <= 0 is not used
+    fCheckpointFile = file;
+    fCheckpointEvents = nEvents;
+    fCheckpointSeconds = seconds;
+}
+//_____________________________________________________________________________
+Long64_t AliAnalysisTaskMCInfo::GetCheckpointEntry(TChain* chain) const
+{
+    // the checkpoint holds the file and the local entry of the next event,
+    // the tree offsets of the chain turn them into an entry of the chain
+    if (fCheckpointFile.IsNull() || !chain) return 0;
+    if (gSystem->AccessPathName(fCheckpointFile.Data())) return 0;
+    TDirectory* dir = gDirectory;
+    TFile* file = TFile::Open(fCheckpointFile.Data());
+    dir->cd();
+    if (!file || file->IsZombie()) {
+        delete file;
+        return 0;
+    }
+    TNamed* config = dynamic_cast<TNamed*>(file->Get("config"));
+    TNamed* name = dynamic_cast<TNamed*>(file->Get("file"));
+    TParameter<Long64_t>* entry = dynamic_cast<TParameter<Long64_t>*>(file->Get("entry"));
+    // the output list is only read when it is restored
+    TKey* output = file->GetKey("output");
+    Long64_t first = 0;
+    if (!config || !name || !entry || !output || strcmp(output->GetClassName(), "TList")) {
+        printf("<E> Checkpoint %s is incomplete, starting from the beginning\n", fCheckpointFile.Data());
+    } else if (GetConfigHash()!=config->GetTitle()) {
+        printf("<E> Checkpoint %s has configuration %s instead of %s, starting from the beginning\n",
+            fCheckpointFile.Data(), config->GetTitle(), GetConfigHash().Data());
+    } else {
+        // GetEntries fills the tree offsets
+        chain->GetEntries();
+        TObjArray* files = chain->GetListOfFiles();
+        Int_t ii = 0;
+        for (; ii<files->GetEntriesFast(); ii++) {
+            if (strcmp(files->At(ii)->GetTitle(), name->GetTitle())) continue;
+            first = chain->GetTreeOffset()[ii] + entry->GetVal();
+            break;
+        }
+        if (ii==files->GetEntriesFast()) {
+            printf("<E> File %s of checkpoint %s is not in the chain, starting from the beginning\n",
+                name->GetTitle(), fCheckpointFile.Data());
+        }
+    }
+    delete file;
+    return first;
+}
+//_____________________________________________________________________________
+void AliAnalysisTaskMCInfo::Checkpoint()
+{
+    // called before each event, all earlier entries are done
+    if (fCheckpointFile.IsNull()) return;
+    Bool_t due = fCheckpointEvents>0 && fNEventsCheckpoint>=fCheckpointEvents;
+    if (!due && fCheckpointSeconds>0) {
+        due = TTimeStamp().AsDouble()-fTimeCheckpoint >= fCheckpointSeconds;
+    }
+    if (due) {
+        WriteCheckpoint();
+        fNEventsCheckpoint = 0;
+        fTimeCheckpoint = TTimeStamp().AsDouble();
+    }
+    fNEventsCheckpoint++;
+}
+//_____________________________________________________________________________
+Bool_t AliAnalysisTaskMCInfo::WriteCheckpoint()
+{
+    // the output list, the configuration and the position of the next event
+    // go to a temporary file, which then replaces the previous checkpoint
+    AliAnalysisManager* mgr = AliAnalysisManager::GetAnalysisManager();
+    TTree* tree = mgr ? mgr->GetTree() : 0x0;
+    if (!tree || !tree->GetCurrentFile()) return kFALSE;
+    // the shards are added to the output histograms
+    if (fHists) fHists->Flush();
+    if (fTimer) fTimer->FillHistograms();
+
+    TString tmpName = fCheckpointFile + ".tmp";
+    TDirectory* dir = gDirectory;
+    TFile* file = TFile::Open(tmpName.Data(), "RECREATE");
+    if (!file || file->IsZombie()) {
+        printf("<E> Cannot write checkpoint %s\n", tmpName.Data());
+        delete file;
+        dir->cd();
+        return kFALSE;
+    }
+    fOutList->Write("output", TObject::kSingleKey);
+    TNamed config("config", GetConfigHash().Data());
+    TNamed name("file", tree->GetCurrentFile()->GetName());
+    TParameter<Long64_t> entry("entry", mgr->GetCurrentEntry());
+    config.Write();
+    name.Write();
+    entry.Write();
+    file->Close();
+    delete file;
+    dir->cd();
+    // the rename replaces the previous checkpoint in one step
+    if (gSystem->Rename(tmpName.Data(), fCheckpointFile.Data())) {
+        printf("<E> Cannot rename %s to %s\n", tmpName.Data(), fCheckpointFile.Data());
+        return kFALSE;
+    }
+    return kTRUE;
+}
+//_____________________________________________________________________________
+static void AddOutput(TList* to, TList* from)
+{
+    // add the objects of from to the objects of the same name in to
+    TIter next(to);
+    while (TObject* obj = next()) {
+        TObject* saved = from->FindObject(obj->GetName());
+        if (!saved) continue;
+        if (obj->InheritsFrom(TList::Class()) && saved->InheritsFrom(TList::Class())) {
+            AddOutput((TList*)obj, (TList*)saved);
+        } else if (obj->InheritsFrom(AliMCInfoPDGCounter::Class())) {
+            ((AliMCInfoPDGCounter*)obj)->Add(dynamic_cast<AliMCInfoPDGCounter*>(saved));
+        } else if (obj->InheritsFrom(TH1::Class()) && saved->InheritsFrom(TH1::Class())) {
+            ((TH1*)obj)->Add((TH1*)saved);
+        }
+    }
+}
+//_____________________________________________________________________________
+Bool_t AliAnalysisTaskMCInfo::RestoreCheckpoint()
+{
+    // the histograms read from the file must not belong to it
+    Bool_t addDirectory = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+    TDirectory* dir = gDirectory;
+    TFile* file = TFile::Open(fCheckpointFile.Data());
+    TList* saved = 0x0;
+    TNamed* config = 0x0;
+    if (file && !file->IsZombie()) {
+        saved = dynamic_cast<TList*>(file->Get("output"));
+        config = dynamic_cast<TNamed*>(file->Get("config"));
+    }
+    TH1::AddDirectory(addDirectory);
+    dir->cd();
+    Bool_t restored = saved && config && GetConfigHash()==config->GetTitle();
+    if (restored) {
+        AddOutput(fOutList, saved);
+    } else {
+        printf("<E> Cannot restore the output of checkpoint %s\n", fCheckpointFile.Data());
+    }
+    if (saved) {
+        saved->SetOwner(kTRUE);
+        delete saved;
+    }
+    delete file;
+    return restored;
 }
 //_____________________________________________________________________________
 void AliAnalysisTaskMCInfo::UserCreateOutputObjects()
@@ -120,13 +503,22 @@ void AliAnalysisTaskMCInfo::UserCreateOutputObjects()
     //
     // this function is called ONCE at the start of the analysis (RUNTIME)
     // here the histograms and other objects are created
+    // the track containers are booked once and reused for every event
     fTrackStatus = new TArrayI();
-    fTracks = new TObjArray();
+    fTracks = new TObjArray(kNTrackCapacity);
+    fBuffers = new AliMCInfoEventBuffers(kNTrackCapacity);
+    fTruth = new AliMCInfoTruthIndex(4096);
 
     fTrigger = new AliTriggerAnalysis();
     fTrigger->SetDoFMD(kTRUE);
     fTrigger->SetFMDThreshold(0.3,0.5);
     fTrigger->ApplyPileUpCuts(kTRUE);
+    // the offline triggers are decoded once per event for all tasks of the
+    // train which use the cache
+    AliMCInfoTriggerCache::Instance()->Request(AliTriggerAnalysis::kV0A);
+    AliMCInfoTriggerCache::Instance()->Request(AliTriggerAnalysis::kV0C);
+    AliMCInfoTriggerCache::Instance()->Request(AliTriggerAnalysis::kADA);
+    AliMCInfoTriggerCache::Instance()->Request(AliTriggerAnalysis::kADC);
     
     // AliCEPUtils
     fCEPUtil = new AliCEPUtils();
@@ -139,20 +531,105 @@ void AliAnalysisTaskMCInfo::UserCreateOutputObjects()
             AliCEPBase::kBitisRun1,AliCEPBase::kBitisRun1);
     fCEPUtil->InitTrackCuts(isRun1,1);  
 
+    // event cuts with a rough cost estimate (relative CPU per event). the
+    // track analysis is by far the most expensive one and always runs last,
+    // also in adaptive mode
+    fCuts = new AliMCInfoCutPipeline();
+    fCuts->AddCut(kCutPileup,  "pileup",    2.);
+    fCuts->AddCut(kCutV0,      "V0",        4.);
+    fCuts->AddCut(kCutSTG,     "STG",       1.);
+    fCuts->AddCut(kCutAD,      "AD",        4.);
+    fCuts->AddCut(kCutFOChips, "FO chips",  1.);
+    fCuts->AddCut(kCutTracks,  "tracks",  100., kFALSE);
+    fCuts->SortByCost();
+    fCuts->SetAdaptive(fAdaptiveCuts);
+
    
     // the histograms are added to a tlist which is in the end saved to an output file
     fOutList = new TList();             // this is a list which will contain all of your histograms
     fOutList->SetOwner(kTRUE);          // memory stuff: the list is owner of all objects 
                                         // it contains and will delete them if requested 
-    fGammaE  = new TH1F("fGammaE",  "fGammaE",  100, 0, 10);       
-    fNeutralPDG = new TH1F("fNeutralPDG", "fNeutralPDG", 100, 0, 2500);
-    fEmcalHitMothers = new TH1F("fEmcalHitMothers", "fEmcalHitMothers", 100, 0, 2500);
-    
-    fOutList->Add(fGammaE);          
-    fOutList->Add(fNeutralPDG);          
-    fOutList->Add(fEmcalHitMothers);          
+    // all histograms filled per event are booked through fHists, which
+    // fills them via per-thread shards and adds them up in FinishTaskOutput
+    fHists = new AliMCInfoHistShards(fNHistShards);
+    fCuts->BookHistogram(fHists, fOutList, "fCutFlow");
+    fCutFlow = fHists->GetHistogram(kHCutFlow);
+    // timing of the cuts and the MC stages
+#if MCINFO_TIMING
+    fTimer = new AliMCInfoStageTimer(kNStages);
+    fTimer->SetStageName(kCutPileup,    "pileup");
+    fTimer->SetStageName(kCutV0,        "trigger V0");
+    fTimer->SetStageName(kCutSTG,       "STG");
+    fTimer->SetStageName(kCutAD,        "trigger AD");
+    fTimer->SetStageName(kCutFOChips,   "FO chips");
+    fTimer->SetStageName(kCutTracks,    "tracks");
+    fTimer->SetStageName(kStageMCTruth, "MC truth");
+    fTimer->SetStageName(kStageXVector, "X vector");
+    fTimer->SetStageName(kStageEMCal,   "EMCal");
+    fTimer->SetStageName(kStageEvent,   "event");
+    fTimer->CreateHistograms(fOutList);
+#endif
+    fHists->Book(fOutList, "fTriggerCache", "fTriggerCache", 2, -0.5, 1.5);
+    fTriggerCache = fHists->GetHistogram(kHTriggerCache);
+    fTriggerCache->GetXaxis()->SetBinLabel(1, "hits");
+    fTriggerCache->GetXaxis()->SetBinLabel(2, "misses");
+    fHists->Book(fOutList, "fSkipped", "fSkipped", kNSkips, -0.5, kNSkips-0.5);
+    fSkipped = fHists->GetHistogram(kHSkipped);
+    fSkipped->GetXaxis()->SetBinLabel(kSkipNoMCEvent+1, "no MC event");
+    fSkipped->GetXaxis()->SetBinLabel(kSkipNoMCParticle+1, "no MC particle");
+    // the track buffers must not allocate once warmed up, bin 2 has to stay empty
+    fHists->Book(fOutList, "fBufferAllocations", "fBufferAllocations", 3, -0.5, 2.5);
+    fBufferAllocations = fHists->GetHistogram(kHBufferAllocations);
+    fBufferAllocations->GetXaxis()->SetBinLabel(1, "warm-up");
+    fBufferAllocations->GetXaxis()->SetBinLabel(2, "after warm-up");
+    fBufferAllocations->GetXaxis()->SetBinLabel(3, "status resized");
+    // with several track-cut configurations, each one gets its own sub-list
+    Int_t nConfigs = GetNTTConfigs();
+    fHists->Book(fOutList, "fTTAccepted", "fTTAccepted", nConfigs, -0.5, nConfigs-0.5);
+    fTTAccepted = fHists->GetHistogram(kHTTAccepted);
+    for (Int_t cfg=0; cfg<nConfigs; cfg++) {
+        TString label = Form("TT_0x%x_0x%x", GetTTmask(cfg), GetTTpattern(cfg));
+        fTTAccepted->GetXaxis()->SetBinLabel(cfg+1, label.Data());
+        TList* list = fOutList;
+        if (nConfigs>1) {
+            list = new TList();
+            list->SetOwner(kTRUE);
+            list->SetName(label.Data());
+            fOutList->Add(list);
+        }
+        fHists->Book(list, "fGammaE", "fGammaE", 100, 0, 10);
+        // exact counts per pdg code, see Terminate for the histograms
+        Int_t coff = cfg*kNCounters;
+        fHists->BookCounter(list, "fNeutralPDG", "fNeutralPDG");
+        fHists->BookCounter(list, "fEmcalHitMothers", "fEmcalHitMothers");
+        fNeutralPDG[cfg] = fHists->GetCounter(coff+kCNeutralPDG);
+        fEmcalHitMothers[cfg] = fHists->GetCounter(coff+kCEmcalHitMothers);
+    }
+    fGammaE = fHists->GetHistogram(kNGlobalHists + kHGammaE);
 
-    PostData(1, fOutputList);           // postdata will notify the analysis manager of changes 
+    if (fEventIndexSlot) {
+        fEventIndex = new TEntryList("MCEventIndex", fEventIndexHash.Data());
+        PostData(fEventIndexSlot, fEventIndex);
+    }
+    if (fSkimSlot) {
+        // the tree has to be created in its output file
+        OpenFile(fSkimSlot);
+        fSkim = new AliMCInfoSkim();
+        fSkimTree = fSkim->CreateTree("MCSkim");
+        PostData(fSkimSlot, fSkimTree);
+    }
+
+    // continue the output of an interrupted run
+    if (!fCheckpointFile.IsNull()) {
+        // GetCheckpointEntry has checked the checkpoint, the run skips its
+        // entries: without its output they would be missing from the result
+        if (fResume && !RestoreCheckpoint())
+            Fatal("UserCreateOutputObjects", "Cannot resume from checkpoint %s", fCheckpointFile.Data());
+        fNEventsCheckpoint = 0;
+        fTimeCheckpoint = TTimeStamp().AsDouble();
+    }
+
+    PostData(1, fOutList);              // postdata will notify the analysis manager of changes 
                                         // and updates to the fOutList object. 
                                         // the manager will in the end take care of writing 
                                         // the output to file so it needs to know what's 
@@ -167,6 +644,7 @@ void AliAnalysisTaskMCInfo::UserExec(Option_t *)
     // and with the static function InputEvent() you have access to the current event. 
     // once you return from the UserExec function, 
     // the manager will retrieve the next event from the chain
+    Checkpoint();
     fESD = dynamic_cast<AliESDEvent*>(InputEvent()); 
     if(!fESD) return;
     // here we filter for events that satisfy the condition (filter-bit 107 in CEP evts)
@@ -176,172 +654,329 @@ void AliAnalysisTaskMCInfo::UserExec(Option_t *)
     // 5: !AD
     // 6: *FO>=1 (to replay OSMB) && *FO<=trks
     // - 2 tracks
-    Int_t nTracksAccept(2);
-    Int_t nTracks = fCEPUtil->AnalyzeTracks(fESDEvent,fTracks,fTrackStatus);
-
-    TArrayI *TTindices  = new TArrayI();
-    UInt_t TTmask(AliCEPUtils::kTTBaseLine), TTpattern(AliCEPUtils::kTTBaseLine);
-    Int_t nTracksTT = fCEPUtil->countstatus(fTrackStatus, fTTmask, fTTpattern, TTindices);
-    if (nTracksTT!=nTracksAccept) return;
-    
-    // remove pileup
-    if (fESD->IsPileupFromSPD(3,0.8,3.,2.,5.)) return;
-    // CCUP13
-    Bool_t isV0A = fTrigger->IsOfflineTriggerFired(fESD, AliTriggerAnalysis::kV0A);
-    Bool_t isV0C = fTrigger->IsOfflineTriggerFired(fESD, AliTriggerAnalysis::kV0C);
-    UInt_t isSTGTriggerFired;
-    const AliMultiplicity *mult = (AliMultiplicity*)fESD->GetMultiplicity();
-    TBits foMap = mult->GetFastOrFiredChips();
-    isSTGTriggerFired  = IsSTGFired(&foMap,0) ? (1<<0) : 0;
-    for (Int_t ii=1; ii<=10; ii++) {
-        isSTGTriggerFired |= IsSTGFired(&foMap,ii) ? (1<<ii) : 0;
-    }
-    if (isV0A || isV0C || !isSTGTriggerFired) return;
-    // !V0
-    // is encorporated in CCUP13
-    // !AD
-    Bool_t isADA = fTrigger->IsOfflineTriggerFired(fESD, AliTriggerAnalysis::kADA);
-    Bool_t isADC = fTrigger->IsOfflineTriggerFired(fESD, AliTriggerAnalysis::kADC);
-    if (isADA || isADC) return;
-    // *FO>=1 (to replay OSMB) && *FO<=trks
-    Short_t nFiredChips[4] = {0};
-    nFiredChips[0] = mult->GetNumberOfFiredChips(0);
-    nFiredChips[1] = mult->GetNumberOfFiredChips(1);
-    for (Int_t ii=0;    ii<400; ii++) nFiredChips[2] += foMap[ii]>0 ? 1 : 0;
-    for (Int_t ii=400; ii<1200; ii++) nFiredChips[3] += foMap[ii]>0 ? 1 : 0;
-    Bool_t firedChipsOK = kTRUE;
-    for (Int_t ii=0; ii<4; ii++) {
-      firedChipsOK =
-        firedChipsOK &&
-        (nFiredChips[ii]>=1) &&
-        (nFiredChips[ii]<=nTracksAccept);
-    }
-    if (!firedChipsOK) return;
+    // the cuts are independent of each other, they are run in the order
+    // given by fCuts (cheap vetoes first)
+    AliMCInfoStageTimer::Scope eventTiming(fTimer, kStageEvent);
+    eventTiming.SetPassed(kFALSE);
+    fFOEvaluated = kFALSE;
+    fTTPassed = 0;
+    fCuts->BeginEvent();
+    // one measurement of each cut feeds fTimer and the adaptive order
+    Bool_t timeCuts = fTimer || fCuts->IsAdaptive();
+    for (Int_t pos=0; pos<fCuts->GetNCuts(); pos++) {
+        Int_t cut = fCuts->GetCutAt(pos);
+        ULong64_t start = timeCuts ? AliMCInfoStageTimer::Now() : 0;
+        Bool_t passed = PassCut(cut);
+        ULong64_t ticks = timeCuts ? AliMCInfoStageTimer::Now()-start : 0;
+        if (fTimer) fTimer->Add(cut, ticks, passed);
+        if (!fCuts->StopCut(pos, passed, ticks)) return;
+    }
+    fCuts->Accept();
+    eventTiming.SetPassed(kTRUE);
+    if (fEventIndex) {
+        // the manager entry is local to the current tree of the chain
+        AliAnalysisManager* mgr = AliAnalysisManager::GetAnalysisManager();
+        fEventIndex->Enter(mgr->GetCurrentEntry(), mgr->GetTree()->GetTree());
+    }
   
     // here we have now events which passed the track selection
+    // of at least one track-cut configuration
     
     // get MC event (fMCEvent is member variable from AliAnalysisTaskSE)
     fMCEvent = MCEvent();
     if (fMCEvent) {  
         if (fMCEvent->Stack()==NULL) fMCEvent=NULL;
     }
-    AliStack *stack = NULL;
+    // the truth index is built in one pass over the stack, all further
+    // MC look-ups of this event are array look-ups
+    TLorentzVector X_lor;
     if (fMCEvent) {
-      stack = fMCEvent->Stack();
-      
-      // update fCEPEvent with MC truth
-      fCEPUtil->SetMCTruth(fCEPEvent,fMCEvent);
-                     
-    } else { printf("<E> No MC-event available!"); gSystem->Exit(1); }
-    // get information if event is fully-reconstructed or not
-    Int_t nTracksMC = stack->GetNtrack();
-    Int_t nTracksPrimMC = stack->GetNprimary();
-    Int_t nTracksTranspMC = stack->GetNtransported();
-    print("Number of\ntracks: %i\nprimaries: %i\ntransported: %i\n----------------------\n", 
-            nTracksMC, nTracksPrimMC, nTracksTranspMC);
-    // get lorentzvector of the X particle
-    TLorentzVector X_lor = GetXLorentzVector(fMCEvent);
-    
-    // calculate the lorentzvector of the measured particles and check if they agree with X_lor
-    TLorentzVector measured_lor = TLorentzVector(0,0,0,0);
-    for (Int_t ii=0; ii<nTracksTT; ii++) {
-        // proper pointer into fTracks and fTrackStatus
-        Int_t trkIndex = TTindices->At(ii);
-        // the original track
-        AliESDtrack *tmptrk = (AliESDtrack*) fTracks->At(trkIndex);
-        // get MC truth
-        Int_t MCind = tmptrk->GetLabel();
-        if (fMCEvent && MCind >= 0) {
-            TParticle* part = stack->Particle(MCind);
-            // set MC mass and momentum
-            TLorentzVector lv;
-            part->Momentum(lv);
-            measured_lor += lv;        
-        } else { printf("<E> No MC-particle info available!"); gSystem->Exit(1); }
+        {
+            AliMCInfoStageTimer::Scope timing(fTimer, kStageMCTruth);
+            fTruth->Build(fMCEvent->Stack());
+        }
+        // get lorentzvector of the X particle
+        AliMCInfoStageTimer::Scope timing(fTimer, kStageXVector);
+        X_lor = GetXLorentzVector(fMCEvent);
     }
-    Double_t m_diff = measured_lor.M() - X_lor.M();
-    if (m_diff < 0) m_diff = -m_diff;
-    if (m_diff < 1e-5) printf("------- Fully reconstruced event!--------\n");
 
-    
+    // one skim record per accepted configuration, written before any MC
+    // check, so that data and incomplete MC events are recorded as well
+    if (fSkim) {
+        for (Int_t cfg=0; cfg<GetNTTConfigs(); cfg++) {
+            if (!(fTTPassed & (1U<<cfg))) continue;
+            Int_t nTracksTT = fBuffers->Select(GetTTmask(cfg), GetTTpattern(cfg));
+            fSkim->BeginEvent(fESD->GetRunNumber(), fESD->GetHeader()->GetEventIdAsLong(),
+                cfg, fSTGMask, fNFiredChips, fMCEvent!=0);
+            if (fMCEvent) fSkim->SetX(X_lor);
+            for (Int_t ii=0; ii<nTracksTT; ii++) {
+                Int_t trkIndex = fBuffers->GetIndex(ii);
+                AliESDtrack *tmptrk = (AliESDtrack*) fBuffers->GetTrack(trkIndex);
+                Int_t MCind = tmptrk->GetLabel();
+                Bool_t inStack = fMCEvent && fTruth->IsValid(MCind);
+                fSkim->AddTrack(tmptrk->Px(), tmptrk->Py(), tmptrk->Pz(), tmptrk->Charge(),
+                    fBuffers->GetStatus(trkIndex), MCind, inStack ? fTruth->GetPdg(MCind) : 0);
+            }
+            fSkim->Fill();
+        }
+        PostData(fSkimSlot, fSkimTree);
+    }
 
-    
+    if (!fMCEvent) {
+        // counted in fSkipped, the run goes on
+        if (fDebug>0 || !(fSkipWarned & (1U<<kSkipNoMCEvent))) {
+            printf("<W> No MC-event available, such events are skipped and counted in fSkipped%s\n",
+                fDebug>0 ? "" : " (reported once)");
+            fSkipWarned |= 1U<<kSkipNoMCEvent;
+        }
+        fHists->Fill(kHSkipped, kSkipNoMCEvent);
+        return;
+    }
+    AliStack *stack = fMCEvent->Stack();
+    // a selected track without MC particle: the event is counted in
+    // fSkipped and skipped, the run goes on
+    for (Int_t cfg=0; cfg<GetNTTConfigs(); cfg++) {
+        if (!(fTTPassed & (1U<<cfg))) continue;
+        Int_t nTracksTT = fBuffers->Select(GetTTmask(cfg), GetTTpattern(cfg));
+        for (Int_t ii=0; ii<nTracksTT; ii++) {
+            AliESDtrack *tmptrk = (AliESDtrack*) fBuffers->GetTrack(fBuffers->GetIndex(ii));
+            if (fTruth->IsValid(tmptrk->GetLabel())) continue;
+            if (fDebug>0 || !(fSkipWarned & (1U<<kSkipNoMCParticle))) {
+                printf("<W> No MC-particle info available, such events are skipped and counted in fSkipped%s\n",
+                    fDebug>0 ? "" : " (reported once)");
+                fSkipWarned |= 1U<<kSkipNoMCParticle;
+            }
+            fHists->Fill(kHSkipped, kSkipNoMCParticle);
+            return;
+        }
+    }
+    // get information if event is fully-reconstructed or not
+    if (fDebug>0) {
+        printf("Number of\ntracks: %i\nprimaries: %i\ntransported: %i\n----------------------\n", 
+            fTruth->GetN(), fTruth->GetNPrimary(), stack->GetNtransported());
+    }
+    for (Int_t cfg=0; cfg<GetNTTConfigs(); cfg++) {
+        if (!(fTTPassed & (1U<<cfg))) continue;
+        fHists->Fill(kHTTAccepted, cfg);
+        // the selected tracks of this configuration
+        Int_t nTracksTT = fBuffers->Select(GetTTmask(cfg), GetTTpattern(cfg));
+
+        // calculate the lorentzvector of the measured particles and check if they agree with X_lor
+        TLorentzVector measured_lor = TLorentzVector(0,0,0,0);
+        for (Int_t ii=0; ii<nTracksTT; ii++) {
+            // proper pointer into fTracks and fTrackStatus
+            Int_t trkIndex = fBuffers->GetIndex(ii);
+            // the original track
+            AliESDtrack *tmptrk = (AliESDtrack*) fBuffers->GetTrack(trkIndex);
+            // get MC truth
+            Int_t MCind = tmptrk->GetLabel();
+            // set MC mass and momentum (the labels are checked above)
+            TLorentzVector lv;
+            fTruth->Momentum(MCind, lv);
+            measured_lor += lv;
+        }
+        Double_t m_diff = measured_lor.M() - X_lor.M();
+        if (m_diff < 0) m_diff = -m_diff;
+        if (fDebug>0 && m_diff < 1e-5) printf("------- Fully reconstruced event (TT config %i)!--------\n", cfg);
+    }
 
- 
+    // the pdg codes of all neutral particles of the event; for the
+    // particles hitting the EMCal the energies of the gammas and the pdg
+    // codes of the primary ancestors. the particles are looked at once and
+    // filled for every accepted configuration. the track references (an
+    // AliMCParticle per particle) are only looked up for the particles
+    // which can reach the EMCal
+    AliMCInfoStageTimer::Scope emcalTiming(fTimer, kStageEMCal);
+    for (Int_t ii=0; ii<fTruth->GetN(); ii++) {
+        Bool_t isNeutral = fTruth->GetCharge(ii)==0;
+        Bool_t hitsEMCal = fTruth->CanReachCylinder(ii, kEMCalCandRadius, kEMCalCandZmax) &&
+                           HitsEMCal(ii);
+        if (!isNeutral && !hitsEMCal) continue;
+        Int_t pdg = fTruth->GetPdg(ii);
+        Int_t ancestor = hitsEMCal ? fTruth->GetAncestor(ii) : ii;
+        for (Int_t cfg=0; cfg<GetNTTConfigs(); cfg++) {
+            if (!(fTTPassed & (1U<<cfg))) continue;
+            Int_t hoff = kNGlobalHists + cfg*kNHists;
+            Int_t coff = cfg*kNCounters;
+            if (isNeutral) fHists->FillCounter(coff+kCNeutralPDG, pdg);
+            if (hitsEMCal && pdg==22) fHists->Fill(hoff+kHGammaE, fTruth->GetE(ii));
+            if (ancestor!=ii) fHists->FillCounter(coff+kCEmcalHitMothers, fTruth->GetPdg(ancestor));
+        }
+    }
 
-    PostData(1, fOutputList);       // stream the results the analysis of this event to
+    if (fEventIndex) PostData(fEventIndexSlot, fEventIndex);
+    PostData(1, fOutList);          // stream the results the analysis of this event to
                                     // the output manager which will take care of writing
                                     // it to a file
 }
 //_____________________________________________________________________________
-void AliAnalysisTaskMCInfo::Terminate(Option_t *)
+Bool_t AliAnalysisTaskMCInfo::PassCut(Int_t cut)
 {
-    // terminate
-    // called at the END of the analysis (when all events are processed)
+    // evaluate one of the event cuts of filter-bit 107
+    switch (cut) {
+        case kCutPileup:
+            // remove pileup
+            return !fESD->IsPileupFromSPD(3,0.8,3.,2.,5.);
+        case kCutV0: {
+            // CCUP13 and !V0
+            return !IsTriggerFired(AliTriggerAnalysis::kV0A) &&
+                   !IsTriggerFired(AliTriggerAnalysis::kV0C);
+        }
+        case kCutSTG:
+            // CCUP13
+            EvaluateFastOR();
+            return fSTGMask!=0;
+        case kCutAD: {
+            // !AD
+            return !IsTriggerFired(AliTriggerAnalysis::kADA) &&
+                   !IsTriggerFired(AliTriggerAnalysis::kADC);
+        }
+        case kCutFOChips: {
+            // *FO>=1 (to replay OSMB) && *FO<=trks
+            EvaluateFastOR();
+            Bool_t firedChipsOK = kTRUE;
+            for (Int_t ii=0; ii<4; ii++) {
+              firedChipsOK =
+                firedChipsOK &&
+                (fNFiredChips[ii]>=1) &&
+                (fNFiredChips[ii]<=kNTracksAccept);
+            }
+            return firedChipsOK;
+        }
+        case kCutTracks:
+            // - 2 tracks, for any of the track-cut configurations. the tracks
+            // are analyzed once and every configuration is applied to the
+            // shared fTrackStatus
+            if (fTwoPhaseRead) LoadLateBranches();
+            fCEPUtil->AnalyzeTracks(fESD,fTracks,fTrackStatus);
+            fBuffers->Reset(fTrackStatus,fTracks);
+            for (Int_t cfg=0; cfg<GetNTTConfigs(); cfg++) {
+                if (fBuffers->Select(GetTTmask(cfg), GetTTpattern(cfg))==kNTracksAccept)
+                    fTTPassed |= 1U<<cfg;
+            }
+            // reallocations of the buffers, checked for every analyzed
+            // event, also the ones rejected here. the buffers only grow, so
+            // after the warm-up they reallocate only for a new largest event.
+            // the status array is resized by AnalyzeTracks itself
+            if (fBuffers->GetNAllocationsInEvent()>0) {
+                Bool_t warm = fBuffers->GetNEvents()>kNWarmUpEvents;
+                fHists->Fill(kHBufferAllocations, warm ? 1 : 0, fBuffers->GetNAllocationsInEvent());
+                if (fDebug>0 && warm) {
+                    printf("<W> %i track buffer allocations in event %lld\n",
+                        fBuffers->GetNAllocationsInEvent(), fBuffers->GetNEvents());
+                }
+            }
+            if (fBuffers->IsStatusResized()) fHists->Fill(kHBufferAllocations, 2);
+            return fTTPassed!=0;
+        default:
+            return kTRUE;
+    }
 }
 //_____________________________________________________________________________
-//
-//
-//------------------------------------------------------------------------------
-// code to check if the STG trigger had fired
-// code from Evgeny Kryshen
-// dphiMin/dphiMax specifies the range for the angle between two tracks
-Bool_t AliAnalysisTaskMCInfo::IsSTGFired(TBits* fFOmap,Int_t dphiMin,Int_t dphiMax)
+void AliAnalysisTaskMCInfo::EvaluateFastOR()
 {
+    // the FastOR map is read once per event: STG replay and fired-chip counts
+    if (fFOEvaluated) return;
+    const AliMultiplicity *mult = (AliMultiplicity*)fESD->GetMultiplicity();
+    fNFiredChips[0] = mult->GetNumberOfFiredChips(0);
+    fNFiredChips[1] = mult->GetNumberOfFiredChips(1);
+    fSTGMask = AliMCInfoFastOR::Evaluate(&mult->GetFastOrFiredChips(),
+        fNFiredChips[2], fNFiredChips[3]);
+    fFOEvaluated = kTRUE;
+}
+//_____________________________________________________________________________
+Bool_t AliAnalysisTaskMCInfo::IsTriggerFired(Int_t trigger)
+{
+    // offline trigger decision through the process-wide cache, the hits and
+    // misses of this task's queries are counted in its own histogram
+    Bool_t hit = kFALSE;
+    Bool_t fired = AliMCInfoTriggerCache::Instance()->IsFired(fTrigger, fESD, trigger, &hit);
+    if (fHists) fHists->Fill(kHTriggerCache, hit ? 0 : 1);
+    return fired;
+}
+//_____________________________________________________________________________
+void AliAnalysisTaskMCInfo::FinishTaskOutput()
+{
+    // called once at the end of the event loop, before the output is written
+    // (and, with PROOF, sent for merging): add up the histogram shards
+    if (fHists) fHists->Flush();
+    if (fTimer) fTimer->FillHistograms();
+}
+//_____________________________________________________________________________
+void AliAnalysisTaskMCInfo::Terminate(Option_t *)
+{
+    // terminate
+    // called at the END of the analysis (when all events are processed)
+    // the run is complete, a new one starts from the beginning
+    if (!fCheckpointFile.IsNull()) gSystem->Unlink(fCheckpointFile.Data());
+    TList* output = dynamic_cast<TList*>(GetOutputData(1));
+    if (!output) return;
 
-  Int_t hitcnt = 0;
-  Bool_t stg = kFALSE;
-  
-  if (!fFOmap) {
-    // printf("<AliAnalysisTaskCEP::IsSTGFired> Problem with F0map - a!\n");
-    return stg;
-  }
-
-  Int_t n1 = fFOmap->CountBits(400);
-  Int_t n0 = fFOmap->CountBits()-n1;
-  if (n0<1 || n1<1) {
-    // printf("<AliAnalysisTaskCEP::IsSTGFired> Problem with F0map - b!\n");
-    return stg;
-  }
-  
-  Bool_t l0[20]={0};
-  Bool_t l1[40]={0};
-  Bool_t phi[20]={0};
-  for (Int_t i=0;   i< 400; ++i) if (fFOmap->TestBitNumber(i)) l0[      i/20] = 1;
-  for (Int_t i=400; i<1200; ++i) if (fFOmap->TestBitNumber(i)) l1[(i-400)/20] = 1;
-  for (Int_t i=0; i<20; ++i) phi[i] = l0[i] & (l1[(2*i)%40] | l1[(2*i+1)%40] | l1[(2*i+2)%40] | l1[(2*i+39)%40]);
-  for (Int_t dphi=dphiMin;dphi<=dphiMax;dphi++) {
-    for (Int_t i=0; i<20; ++i) {
-      stg |= phi[i] & phi[(i+dphi)%20];
-      if (phi[i] & phi[(i+dphi)%20]) hitcnt++;
-    }
-  }
-  // printf("hitcnt: %i\n",hitcnt);
-
-  return stg;
+    // labelled histograms of the (merged) pdg counters, written with the list
+    TList* lists[kMaxTTConfigs+1];
+    Int_t nLists = 0;
+    lists[nLists++] = output;
+    TIter nextList(output);
+    while (TObject* obj = nextList()) {
+        if (nLists<=kMaxTTConfigs && obj->InheritsFrom(TList::Class())) lists[nLists++] = (TList*)obj;
+    }
+    for (Int_t ii=0; ii<nLists; ii++) {
+        TIter next(lists[ii]);
+        TList counters;
+        while (TObject* obj = next()) {
+            if (obj->InheritsFrom(AliMCInfoPDGCounter::Class())) counters.Add(obj);
+        }
+        TIter nextCounter(&counters);
+        while (AliMCInfoPDGCounter* counter = (AliMCInfoPDGCounter*)nextCounter()) {
+            lists[ii]->Add(counter->CreateHistogram(Form("%sHist", counter->GetName())));
+        }
+    }
 
+    // summary of the (merged) stage timing, also as MCInfoTiming.json
+    TH1* hCalls    = dynamic_cast<TH1*>(output->FindObject("fStageCalls"));
+    TH1* hRejected = dynamic_cast<TH1*>(output->FindObject("fStageRejected"));
+    TH1* hTime     = dynamic_cast<TH1*>(output->FindObject("fStageTime"));
+    if (!hCalls || !hRejected || !hTime) return;
+    TString json = "{\"stages\": [";
+    for (Int_t ii=1; ii<=hTime->GetNbinsX(); ii++) {
+        Double_t calls = hCalls->GetBinContent(ii);
+        json += Form("%s\n  {\"name\": \"%s\", \"calls\": %.0f, \"accepted\": %.0f, \"rejected\": %.0f, "
+                     "\"time_ns\": %.0f, \"ns_per_call\": %.1f}",
+            ii>1 ? "," : "", hTime->GetXaxis()->GetBinLabel(ii), calls,
+            calls-hRejected->GetBinContent(ii), hRejected->GetBinContent(ii), hTime->GetBinContent(ii),
+            calls>0 ? hTime->GetBinContent(ii)/calls : 0.);
+    }
+    json += "\n]}\n";
+    printf("%s", json.Data());
+    FILE* summary = fopen("MCInfoTiming.json", "w");
+    if (summary) {
+        fputs(json.Data(), summary);
+        fclose(summary);
+    }
 }
-
 //_____________________________________________________________________________
 TLorentzVector AliAnalysisTaskMCInfo::GetXLorentzVector(AliMCEvent* MCevent)
 {
     // MC generator and process type
     TString fMCGenerator;
     Int_t fMCProcess; 
-    fCEPUtil->DetermineMCprocessType(fMCEvent,fMCGenerator,fMCProcess);
+    fCEPUtil->DetermineMCprocessType(MCevent,fMCGenerator,fMCProcess);
 
-    TLorentzVector lvtmp;
+    // the truth index of the event has to be built already
     TLorentzVector lvprod = TLorentzVector(0,0,0,0);
-    if ( fMCGenerator.EqualTo("Pythia") && fMCProcess==106 )
-    {
-        stack->Particle(4)->Momentum(lvtmp);
-        lvprod  = lvtmp;
-        for (Int_t ii=5; ii<nPrimaries; ii++) {
-            if (stack->Particle(ii)->GetMother(0)==0) {
-                stack->Particle(ii)->Momentum(lvtmp);
-                lvprod += lvtmp;
-            }
-        }
-    }
+    if ( fMCGenerator.EqualTo("Pythia") && fMCProcess==106 ) fTruth->XMomentum(lvprod);
     return lvprod;
 }
+
+//_____________________________________________________________________________
+Bool_t AliAnalysisTaskMCInfo::HitsEMCal(Int_t ii)
+{
+    // does particle ii leave a track reference in the EMCal
+    AliMCParticle* mcpart = (AliMCParticle*)fMCEvent->GetTrack(ii);
+    if (!mcpart) return kFALSE;
+    for (Int_t jj=0; jj<mcpart->GetNumberOfTrackReferences(); jj++) {
+        AliTrackReference* ref = mcpart->GetTrackReference(jj);
+        if (ref && ref->DetectorId()==AliTrackReference::kEMCAL) return kTRUE;
+    }
+    return kFALSE;
+}
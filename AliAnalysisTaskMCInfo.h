@@ -5,13 +5,28 @@
 #ifndef AliAnalysisTaskMCInfo_H
 #define AliAnalysisTaskMCInfo_H
 
+#include "TArrayI.h"
+#include "TLorentzVector.h"
 #include "AliAnalysisTaskSE.h"
 
+class AliCEPUtils;
+class AliMCInfoCutPipeline;
+class AliMCInfoEventBuffers;
+class AliMCInfoTruthIndex;
+class AliMCInfoHistShards;
+class AliMCInfoPDGCounter;
+class AliMCInfoSkim;
+class AliMCInfoStageTimer;
+class TChain;
+class TEntryList;
+class TTree;
+
 class AliAnalysisTaskMCInfo : public AliAnalysisTaskSE  
 {
     public:
                                 AliAnalysisTaskMCInfo();
-                                AliAnalysisTaskMCInfo(const char *name);
+                                AliAnalysisTaskMCInfo(const char *name,
+                                    Long_t state, UInt_t TTmask, UInt_t TTpattern);
         virtual                 ~AliAnalysisTaskMCInfo();
 
         // these functions also exist in AliAnalysisTaskSE (SE=single event)
@@ -19,28 +34,156 @@ class AliAnalysisTaskMCInfo : public AliAnalysisTaskSE
         // original ones, we make them 'virtual' functions
         virtual void            UserCreateOutputObjects();
         virtual void            UserExec(Option_t* option);
+        virtual void            FinishTaskOutput();
         virtual void            Terminate(Option_t* option);
 
+        // reorder the event cuts by their measured rejection per time
+        void                    SetAdaptiveCutOrder(Bool_t adaptive) { fAdaptiveCuts = adaptive; }
+        // further track-cut configuration, evaluated on the same events as
+        // (TTmask, TTpattern) of the constructor
+        void                    AddTTConfig(UInt_t TTmask, UInt_t TTpattern);
+        Int_t                   GetNTTConfigs() const   { return 1+fTTmasks.GetSize(); }
+        // write the entries of chain which pass the event selection to an
+        // extra output slot (a TEntryList titled with GetEventIndexHash);
+        // returns the slot
+        Int_t                   SetWriteEventIndex(TChain* chain);
+        Int_t                   GetEventIndexSlot() const { return fEventIndexSlot; }
+        // write one compact record per selected event to an extra output slot
+        // (a TTree); returns the slot
+        Int_t                   SetWriteSkim();
+        Int_t                   GetSkimSlot() const     { return fSkimSlot; }
+        // ESD branches read by the task: the input handler can switch off all
+        // other branches. in two-phase mode the track branches are left out
+        // and read by the task only for events which pass the event vetoes
+        void                    AddRequiredBranch(const char* branch);
+        void                    SetTwoPhaseRead(Bool_t twoPhase) { fTwoPhaseRead = twoPhase; }
+        TString                 GetActiveBranches() const;
+        // hash of everything which decides if an event is selected
+        TString                 GetConfigHash() const;
+        // hash of the configuration and of the files of chain with their
+        // entries: an event index is only valid for the same input
+        TString                 GetEventIndexHash(TChain* chain) const;
+        // local mode: save the output list and the chain position to file
+        // (atomically, via a temporary file) every nEvents events or every
+        // seconds, whichever comes first. with resume, the output of the
+        // checkpoint is restored at the start and accumulated into
+        void                    SetCheckpoint(const char* file, Long64_t nEvents=10000,
+                                    Double_t seconds=600);
+        void                    SetResume(Bool_t resume) { fResume = resume; }
+        // entry of chain at which the run of the checkpoint continues, 0 if
+        // there is no complete checkpoint of the same configuration
+        // (GetConfigHash). a resumed run which then cannot restore the
+        // output of the checkpoint stops with a fatal error
+        Long64_t                GetCheckpointEntry(TChain* chain) const;
+        // number of threads which may fill the histograms concurrently
+        void                    SetNHistShards(Int_t nShards) { fNHistShards = nShards; }
+
+        // event cuts of filter-bit 107, see UserCreateOutputObjects for the
+        // cost estimates and the default (cheapest first) order
+        enum {
+            kCutPileup = 0,     // SPD pileup
+            kCutV0,             // !V0A && !V0C
+            kCutSTG,            // STG replay
+            kCutAD,             // !ADA && !ADC
+            kCutFOChips,        // 1 <= fired FastOR chips <= tracks
+            kCutTracks,         // track selection
+            kNCuts
+        };
+        // stages timed by fTimer: the event cuts above and the MC part
+        enum {
+            kStageMCTruth = kNCuts, // truth index of the stack
+            kStageXVector,          // GetXLorentzVector
+            kStageEMCal,            // EMCal hit search and fills
+            kStageEvent,            // all of UserExec
+            kNStages
+        };
+        // cylinder around the EMCal front face [cm] (R = 428, |eta| < 0.7
+        // gives |z| < 325) with a margin for energy loss and scattering: only
+        // particles which can cross it are looked up for track references
+        enum { kEMCalCandRadius = 400, kEMCalCandZmax = 400 };
+        enum { kNTracksAccept = 2 };
+        enum { kNWarmUpEvents = 100 };  // events before the buffers must be stable
+        enum { kNTrackCapacity = 256 }; // initial size of the track buffers
+        // histograms filled through fHists, in booking order: first the
+        // global ones, then per configuration
+        // (handle of configuration cfg: kNGlobalHists + cfg*kNHists + histogram)
+        enum { kHCutFlow = 0, kHTriggerCache, kHSkipped, kHBufferAllocations,
+               kHTTAccepted, kNGlobalHists };
+        enum { kHGammaE = 0, kNHists };
+        // pdg counters filled through fHists, in booking order
+        // (handle of configuration cfg: cfg*kNCounters + counter)
+        enum { kCNeutralPDG = 0, kCEmcalHitMothers, kNCounters };
+        enum { kMaxTTConfigs = 32 };
+        // events skipped for missing MC information
+        enum { kSkipNoMCEvent = 0, kSkipNoMCParticle, kNSkips };
+        // to be increased whenever the event selection code changes
+        enum { kEventSelectionVersion = 1 };
+
     private:
         AliESDEvent*            fESD;               //! input event
         AliTriggerAnalysis*     fTrigger;           //! trigger object
+        AliCEPUtils*            fCEPUtil;           //! CEP utilities
+        AliMCInfoCutPipeline*   fCuts;              //! event cuts
         TArrayI*                fTrackStatus;       //! array of track-status
         TObjArray*              fTracks;            //! array of AliESDtracks
+        AliMCInfoEventBuffers*  fBuffers;           //! per-event track selection buffers
+        AliMCInfoTruthIndex*    fTruth;             //! per-event MC truth index
+        UInt_t                  fTTPassed;          //! configurations passing the track selection
+        Bool_t                  fFOEvaluated;       //! FastOR map evaluated for this event
+        UInt_t                  fSTGMask;           //! STG dphi mask
+        Short_t                 fNFiredChips[4];    //! fired chips (SPD layers, FastOR layers)
         Long_t                  fAnalysisStatus;    //  stores the analysis-status 
         UInt_t                  fTTmask;            //  track conditions
         UInt_t                  fTTpattern;         //  track conditions
+        TArrayI                 fTTmasks;           //  track conditions of further configurations
+        TArrayI                 fTTpatterns;        //  track conditions of further configurations
+        Bool_t                  fAdaptiveCuts;      //  adaptive order of the event cuts
+        Int_t                   fNHistShards;       //  shards of the filled histograms
+        Int_t                   fEventIndexSlot;    //  output slot of the event index, 0: none
+        TString                 fEventIndexHash;    //  title of the event index
+        Int_t                   fSkimSlot;          //  output slot of the skim tree, 0: none
+        TString                 fRequiredBranches;  //  ESD branches read by the task
+        TString                 fLateBranches;      //  branches read after the vetoes in two-phase mode
+        Bool_t                  fTwoPhaseRead;      //  read fLateBranches only for events passing the vetoes
+        TString                 fCheckpointFile;    //  checkpoint file, empty: none
+        Long64_t                fCheckpointEvents;  //  events between checkpoints
+        Double_t                fCheckpointSeconds; //  seconds between checkpoints
+        Bool_t                  fResume;            //  restore the output of fCheckpointFile
+        Long64_t                fNEventsCheckpoint; //! events since the last checkpoint
+        Double_t                fTimeCheckpoint;    //! time of the last checkpoint
         // Output objects 
         TList*                  fOutList;           //! output list
+        AliMCInfoHistShards*    fHists;             //! sharded histograms of fOutList
+        AliMCInfoStageTimer*    fTimer;             //! per-stage timing and counters
+        TH1F*                   fCutFlow;           //! events rejected per cut
+        TH1F*                   fTTAccepted;        //! accepted events per track-cut configuration
+        TH1F*                   fTriggerCache;      //! hits and misses of this task's trigger-cache queries
+        TH1F*                   fSkipped;           //! events skipped for missing MC information
+        TH1F*                   fBufferAllocations; //! buffer reallocations during and after the warm-up, status resizes
+        UInt_t                  fSkipWarned;        //! skip reasons (1<<kSkip...) already reported
+        TEntryList*             fEventIndex;        //! entries passing the event selection
+        AliMCInfoSkim*          fSkim;              //! record of the selected events
+        TTree*                  fSkimTree;          //! skim output
         TH1F*                   fGammaE;            //! energies of gammas in emcal
-        TH1F*                   fNeutralPDG;        //! neutral particles pdg
-        TH1F*                   fEmcalHitMothers;   //! mothers of the hitting particles 
+        AliMCInfoPDGCounter*    fNeutralPDG[kMaxTTConfigs];      //! neutral particles pdg, per configuration
+        AliMCInfoPDGCounter*    fEmcalHitMothers[kMaxTTConfigs]; //! primary ancestors of the hitting particles, per configuration
         // not implemented but neccessary
         AliAnalysisTaskMCInfo(const AliAnalysisTaskMCInfo&); 
         AliAnalysisTaskMCInfo& operator=(const AliAnalysisTaskMCInfo&); 
 
-        Bool_t IsSTGFired(TBits* fFOmap,Int_t dphiMin=0,Int_t dphiMax=10);
+        Bool_t PassCut(Int_t cut);
+        void   EvaluateFastOR();
+        Bool_t IsTriggerFired(Int_t trigger);
+        TLorentzVector GetXLorentzVector(AliMCEvent* MCevent);
+        Bool_t HitsEMCal(Int_t ii);
+        void   LoadLateBranches();
+        void   Checkpoint();
+        Bool_t WriteCheckpoint();
+        Bool_t RestoreCheckpoint();
+        UInt_t GetTTmask(Int_t cfg) const    { return cfg ? (UInt_t)fTTmasks[cfg-1] : fTTmask; }
+        UInt_t GetTTpattern(Int_t cfg) const { return cfg ? (UInt_t)fTTpatterns[cfg-1] : fTTpattern; }
 
-        ClassDef(AliAnalysisTaskMCInfo, 1);
+        ClassDef(AliAnalysisTaskMCInfo, 9);
 };
 
 #endif
@@ -0,0 +1,177 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoCutPipeline_H
+#define AliMCInfoCutPipeline_H
+
+#include <algorithm>
+#include <vector>
+
+#include "TH1F.h"
+#include "TList.h"
+#include "AliMCInfoHistShards.h"
+
+// ordered list of event cuts
+//
+// every cut is registered with an id (interpreted by the task), a name and
+// a cost estimate. the cuts are run cheapest first; in adaptive mode the
+// movable cuts are reordered periodically by their measured rejection per
+// time, cuts not measured yet by their cost estimate. the time of a cut is
+// measured by the caller (in any unit, e.g. the ticks of
+// AliMCInfoStageTimer) and passed to StopCut. since all cuts
+// must pass, the order changes only the CPU time, never the selected
+// events. the cut-flow histogram is binned by registration order, but an
+// event failing several cuts is credited to the first of them in the
+// current order: in adaptive mode the rejections per cut therefore depend
+// on the ordering, only "all" and "accepted" do not
+class AliMCInfoCutPipeline
+{
+    public:
+                                AliMCInfoCutPipeline();
+
+        void                    AddCut(Int_t id, const char* name, Double_t cost, Bool_t movable=kTRUE);
+        void                    SortByCost();
+        void                    SetAdaptive(Bool_t adaptive, Int_t period=1000)
+                                    { fAdaptive = adaptive; fPeriod = period>0 ? period : 1; }
+        Bool_t                  IsAdaptive() const      { return fAdaptive; }
+
+        Int_t                   GetNCuts() const        { return fCuts.size(); }
+        Int_t                   GetCutAt(Int_t pos) const { return fCuts[fOrder[pos]].fId; }
+        Long64_t                GetNRejected(Int_t pos) const { return fCuts[fOrder[pos]].fNRejected; }
+
+        // per-event bookkeeping
+        void                    BeginEvent();
+        // time: spent in the cut, only used in adaptive mode
+        Bool_t                  StopCut(Int_t pos, Bool_t passed, Double_t time=0.);
+        void                    Accept();
+
+        // book the cut-flow histogram into list, filled through the shards
+        // of hists
+        Int_t                   BookHistogram(AliMCInfoHistShards* hists, TList* list, const char* name);
+
+    private:
+        struct Cut {
+            Int_t               fId;            // id known to the task
+            TString             fName;          // label in the cut-flow histogram
+            Double_t            fCost;          // a-priori cost estimate
+            Bool_t              fMovable;       // may be reordered in adaptive mode
+            Long64_t            fNEvaluated;    // events which reached this cut
+            Long64_t            fNRejected;     // events rejected by this cut
+            Double_t            fTime;          // total time spent in the cut
+        };
+        void                    Reorder();
+
+        std::vector<Cut>        fCuts;          // cuts in registration order
+        std::vector<Int_t>      fOrder;         // evaluation order
+        Bool_t                  fAdaptive;      // reorder by measured rejection/time
+        Int_t                   fPeriod;        // events between reorderings
+        Long64_t                fNEvents;       // events seen
+        AliMCInfoHistShards*    fHists;         // shards of the cut-flow histogram (not owned)
+        Int_t                   fHistId;        // handle of the cut-flow histogram in fHists
+};
+
+//_____________________________________________________________________________
+inline AliMCInfoCutPipeline::AliMCInfoCutPipeline()
+  : fCuts()
+  , fOrder()
+  , fAdaptive(kFALSE)
+  , fPeriod(1000)
+  , fNEvents(0)
+  , fHists(0)
+  , fHistId(-1)
+{
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoCutPipeline::AddCut(Int_t id, const char* name, Double_t cost, Bool_t movable)
+{
+    Cut cut = { id, name, cost, movable, 0, 0, 0. };
+    fOrder.push_back(fCuts.size());
+    fCuts.push_back(cut);
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoCutPipeline::SortByCost()
+{
+    // cheapest first, ties keep the registration order
+    std::stable_sort(fOrder.begin(), fOrder.end(),
+        [this](Int_t a, Int_t b) { return fCuts[a].fCost < fCuts[b].fCost; });
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoCutPipeline::BeginEvent()
+{
+    fNEvents++;
+    if (fHists) fHists->Fill(fHistId, 0);
+    if (fAdaptive && fNEvents%fPeriod==0) Reorder();
+}
+
+//_____________________________________________________________________________
+inline Bool_t AliMCInfoCutPipeline::StopCut(Int_t pos, Bool_t passed, Double_t time)
+{
+    Cut& cut = fCuts[fOrder[pos]];
+    cut.fTime += time;
+    cut.fNEvaluated++;
+    if (!passed) {
+        cut.fNRejected++;
+        if (fHists) fHists->Fill(fHistId, 1 + fOrder[pos]);
+    }
+    return passed;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoCutPipeline::Accept()
+{
+    if (fHists) fHists->Fill(fHistId, 1 + fCuts.size());
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoCutPipeline::BookHistogram(AliMCInfoHistShards* hists, TList* list, const char* name)
+{
+    // bin 1: all events, then one bin per cut with the events it rejected,
+    // last bin: accepted events
+    Int_t nbins = fCuts.size() + 2;
+    fHists = hists;
+    fHistId = hists->Book(list, name, name, nbins, -0.5, nbins-0.5);
+    TH1F* hist = hists->GetHistogram(fHistId);
+    hist->GetXaxis()->SetBinLabel(1, "all");
+    for (UInt_t ii=0; ii<fCuts.size(); ii++)
+        hist->GetXaxis()->SetBinLabel(ii+2, fCuts[ii].fName.Data());
+    hist->GetXaxis()->SetBinLabel(nbins, "accepted");
+    return fHistId;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoCutPipeline::Reorder()
+{
+    // sort the movable cuts by rejection probability per mean time, the
+    // fixed cuts keep their position. a cut without a measurement gets its
+    // cost estimate as prior: rejection probability 1/2 and the time of its
+    // cost, converted with the time per cost unit of the measured cuts
+    std::vector<Int_t> slots, movable;
+    Double_t timePerCost = 0.;
+    Int_t nMeasured = 0;
+    for (UInt_t pos=0; pos<fOrder.size(); pos++) {
+        const Cut& cut = fCuts[fOrder[pos]];
+        if (cut.fNEvaluated>0 && cut.fTime>0. && cut.fCost>0.) {
+            timePerCost += cut.fTime / cut.fNEvaluated / cut.fCost;
+            nMeasured++;
+        }
+        if (!cut.fMovable) continue;
+        slots.push_back(pos);
+        movable.push_back(fOrder[pos]);
+    }
+    timePerCost = nMeasured>0 ? timePerCost/nMeasured : 1.;
+    auto score = [this, timePerCost](Int_t ii) {
+        const Cut& cut = fCuts[ii];
+        if (cut.fNEvaluated==0 || cut.fTime<=0.)
+            return 0.5 / (std::max(cut.fCost, 1e-6) * timePerCost);
+        return (cut.fNRejected+1.) / (cut.fNEvaluated+2.) / (cut.fTime / cut.fNEvaluated);
+    };
+    std::stable_sort(movable.begin(), movable.end(),
+        [&score](Int_t a, Int_t b) { return score(a) > score(b); });
+    for (UInt_t ii=0; ii<slots.size(); ii++) fOrder[slots[ii]] = movable[ii];
+}
+
+#endif
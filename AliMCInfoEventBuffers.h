@@ -0,0 +1,121 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoEventBuffers_H
+#define AliMCInfoEventBuffers_H
+
+#include <vector>
+
+#include "TArrayI.h"
+#include "TObjArray.h"
+
+// per-event scratch buffers of the track selection
+//
+// the buffers are booked once and only reset between events. the status
+// and track arrays (owned by the task, filled by AliCEPUtils::AnalyzeTracks)
+// are not copied but referenced (non-owning views), the indices of the
+// selected tracks are kept in a vector which grows to the largest event.
+// the reallocations are counted from their causes, not guessed from the
+// storage addresses (the allocator may return the same block):
+// - the index vector and the track array (TObjArray::Expand) only grow, they
+//   reallocate when an event has more tracks than any event before
+// - the status array is resized by AnalyzeTracks with TArrayI::Set, which
+//   reallocates at every change of the number of tracks; this is outside
+//   the task and counted separately
+class AliMCInfoEventBuffers
+{
+    public:
+                                AliMCInfoEventBuffers(Int_t capacity=64);
+
+        // start a new event on the arrays filled by AnalyzeTracks
+        void                    Reset(const TArrayI* status, const TObjArray* tracks);
+        // select the tracks with (status & mask) == pattern
+        Int_t                   Select(UInt_t mask, UInt_t pattern);
+
+        Int_t                   GetNTracks() const      { return fNTracks; }
+        Int_t                   GetNSelected() const    { return fNSelected; }
+        Int_t                   GetIndex(Int_t ii) const { return fIndices[ii]; }
+        Int_t                   GetStatus(Int_t trk) const { return fStatus[trk]; }
+        TObject*                GetTrack(Int_t trk) const { return fTracks[trk]; }
+
+        Long64_t                GetNEvents() const      { return fNEvents; }
+        // reallocations of the index vector and the track array
+        Long64_t                GetNAllocations() const { return fNAllocations; }
+        Int_t                   GetNAllocationsInEvent() const { return fNAllocInEvent; }
+        // reallocations of the status array by TArrayI::Set
+        Long64_t                GetNStatusResizes() const { return fNStatusResizes; }
+        Bool_t                  IsStatusResized() const { return fStatusResized; }
+
+    private:
+        std::vector<Int_t>      fIndices;       // indices of the selected tracks
+        Int_t                   fNSelected;     // used part of fIndices
+        const Int_t*            fStatus;        // view on the track status
+        TObject* const*         fTracks;        // view on the tracks
+        Int_t                   fNTracks;       // length of both views
+        Int_t                   fStatusSize;    // size of the status array, -1: none yet
+        Int_t                   fTracksCapacity;// capacity of the track array, -1: none yet
+        Long64_t                fNEvents;       // events seen
+        Long64_t                fNAllocations;  // reallocations in all events
+        Int_t                   fNAllocInEvent; // reallocations in the current event
+        Long64_t                fNStatusResizes;// status reallocations in all events
+        Bool_t                  fStatusResized; // status reallocated in the current event
+};
+
+//_____________________________________________________________________________
+inline AliMCInfoEventBuffers::AliMCInfoEventBuffers(Int_t capacity)
+  : fIndices(capacity>0 ? capacity : 1)
+  , fNSelected(0)
+  , fStatus(0)
+  , fTracks(0)
+  , fNTracks(0)
+  , fStatusSize(-1)
+  , fTracksCapacity(-1)
+  , fNEvents(0)
+  , fNAllocations(0)
+  , fNAllocInEvent(0)
+  , fNStatusResizes(0)
+  , fStatusResized(kFALSE)
+{
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoEventBuffers::Reset(const TArrayI* status, const TObjArray* tracks)
+{
+    fNEvents++;
+    fNAllocInEvent = 0;
+    fNSelected = 0;
+
+    fStatus  = status ? status->GetArray() : 0;
+    fTracks  = tracks ? tracks->GetObjectRef() : 0;
+    fNTracks = status ? status->GetSize() : 0;
+    if (tracks && tracks->GetEntriesFast()<fNTracks) fNTracks = tracks->GetEntriesFast();
+
+    // TArrayI::Set reallocates at every change of the size, the track
+    // array reallocates when Expand raises its capacity
+    Int_t statusSize = status ? status->GetSize() : 0;
+    Int_t tracksCapacity = tracks ? tracks->GetSize() : 0;
+    fStatusResized = fStatusSize>=0 && statusSize!=fStatusSize;
+    if (fStatusResized) fNStatusResizes++;
+    if (fTracksCapacity>=0 && tracksCapacity>fTracksCapacity) fNAllocInEvent++;
+    fStatusSize = statusSize;
+    if (tracksCapacity>fTracksCapacity) fTracksCapacity = tracksCapacity;
+    fNAllocations += fNAllocInEvent;
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoEventBuffers::Select(UInt_t mask, UInt_t pattern)
+{
+    if ((Int_t)fIndices.size()<fNTracks) {
+        fIndices.resize(fNTracks);
+        fNAllocInEvent++;
+        fNAllocations++;
+    }
+    fNSelected = 0;
+    for (Int_t ii=0; ii<fNTracks; ii++) {
+        if (((UInt_t)fStatus[ii] & mask) == pattern) fIndices[fNSelected++] = ii;
+    }
+    return fNSelected;
+}
+
+#endif
@@ -0,0 +1,153 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoFastOR_H
+#define AliMCInfoFastOR_H
+
+#include "TBits.h"
+
+// bit-parallel evaluation of the SPD FastOR map
+//
+// the 1200 FastOR chips (0-399: inner layer, 400-1199: outer layer) are
+// copied once into 64-bit words. the sector occupancy of both layers,
+// the STG coincidences and the number of fired chips per layer are then
+// obtained with popcounts and shift/mask operations on these words
+class AliMCInfoFastOR
+{
+    public:
+        enum {
+            kNChipsL0     = 400,    // chips in the inner layer
+            kNChips       = 1200,   // chips in both layers
+            kNWords       = 19,     // 64-bit words holding kNChips bits
+            kNSectL0      = 20,     // phi sectors in the inner layer
+            kNSectL1      = 40,     // phi sectors in the outer layer
+            kChipsPerSect = 20,     // chips per phi sector
+            kMaxDphi      = 10      // largest distinct sector distance
+        };
+
+        // returns the STG mask: bit dphi (0..kMaxDphi) is set if two fired
+        // phi sectors are exactly dphi sectors apart (a distance dphi>kMaxDphi
+        // is the same coincidence as 20-dphi). nChipsL0 and nChipsL1 receive
+        // the number of fired chips in the inner and outer layer
+        static UInt_t       Evaluate(const TBits* foMap, Short_t& nChipsL0, Short_t& nChipsL1);
+        // STG decision for the sector distances dphiMin..dphiMax (any
+        // non-negative values) from the mask returned by Evaluate
+        static Bool_t       IsSTGFired(UInt_t stgMask, Int_t dphiMin, Int_t dphiMax);
+
+        static Int_t        PopCount(ULong64_t w);
+        static Int_t        CountRange(const ULong64_t* w, Int_t lo, Int_t hi);
+
+    private:
+        static ULong64_t    Sector(const ULong64_t* w, Int_t pos);
+};
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoFastOR::PopCount(ULong64_t w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (Int_t)((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoFastOR::CountRange(const ULong64_t* w, Int_t lo, Int_t hi)
+{
+    // number of set bits in [lo,hi)
+    Int_t n = 0;
+    if (hi <= lo) return n;
+    Int_t kfirst = lo >> 6, klast = (hi-1) >> 6;
+    for (Int_t k=kfirst; k<=klast; k++) {
+        ULong64_t m = ~0ULL;
+        if (k==kfirst) m &= ~0ULL << (lo & 63);
+        if (k==klast && (hi & 63)) m &= (1ULL << (hi & 63)) - 1;
+        n += PopCount(w[k] & m);
+    }
+    return n;
+}
+
+//_____________________________________________________________________________
+inline ULong64_t AliMCInfoFastOR::Sector(const ULong64_t* w, Int_t pos)
+{
+    // the kChipsPerSect bits starting at pos, which may straddle two words
+    Int_t k = pos >> 6, s = pos & 63;
+    ULong64_t v = w[k] >> s;
+    if (s > 64-kChipsPerSect) v |= w[k+1] << (64-s);
+    return v & ((1ULL << kChipsPerSect) - 1);
+}
+
+//_____________________________________________________________________________
+inline UInt_t AliMCInfoFastOR::Evaluate(const TBits* foMap, Short_t& nChipsL0, Short_t& nChipsL1)
+{
+    nChipsL0 = nChipsL1 = 0;
+    if (!foMap) return 0;
+
+    // copy the map into words. AliMultiplicity books exactly kNChips bits,
+    // larger maps take the (slow) set-bit walk but give the same result
+    UChar_t bytes[kNWords*8] = {0};
+    if (foMap->GetNbytes() <= sizeof(bytes)) {
+        foMap->Get(bytes);
+    } else {
+        for (UInt_t i=foMap->FirstSetBit(); i<(UInt_t)kNChips; i=foMap->FirstSetBit(i+1))
+            bytes[i>>3] |= 1 << (i & 7);
+    }
+    ULong64_t w[kNWords];
+    for (Int_t k=0; k<kNWords; k++) {
+        w[k] = 0;
+        for (Int_t j=0; j<8; j++) w[k] |= (ULong64_t)bytes[8*k+j] << (8*j);
+    }
+
+    nChipsL0 = CountRange(w, 0, kNChipsL0);
+    nChipsL1 = CountRange(w, kNChipsL0, kNChips);
+    // bits beyond the last chip count to the outer layer for the STG
+    // precondition, as TBits::CountBits(400) does
+    Int_t nExtra = foMap->GetNbits() > (UInt_t)kNChips ? foMap->CountBits(kNChips) : 0;
+    if (nChipsL0<1 || nChipsL1+nExtra<1) return 0;
+
+    // sector occupancy
+    UInt_t    l0 = 0;
+    ULong64_t l1 = 0;
+    for (Int_t i=0; i<kNSectL0; i++)
+        if (Sector(w, i*kChipsPerSect)) l0 |= 1U << i;
+    for (Int_t i=0; i<kNSectL1; i++)
+        if (Sector(w, kNChipsL0 + i*kChipsPerSect)) l1 |= 1ULL << i;
+
+    // an inner sector i is matched by the outer sectors 2i-1 .. 2i+2
+    const ULong64_t m40 = (1ULL << kNSectL1) - 1;
+    ULong64_t near = l1
+                   | ((l1 >> 1) | (l1 << (kNSectL1-1)))
+                   | ((l1 >> 2) | (l1 << (kNSectL1-2)))
+                   | ((l1 << 1) | (l1 >> (kNSectL1-1)));
+    near &= m40;
+    UInt_t phi = 0;
+    for (Int_t i=0; i<kNSectL0; i++)
+        if ((l0 >> i) & (near >> (2*i)) & 1) phi |= 1U << i;
+
+    // coincidences of two phi sectors dphi apart
+    const UInt_t m20 = (1U << kNSectL0) - 1;
+    UInt_t stg = 0;
+    for (Int_t dphi=0; dphi<=kMaxDphi; dphi++) {
+        UInt_t rot = dphi ? ((phi >> dphi) | (phi << (kNSectL0-dphi))) & m20 : phi;
+        if (phi & rot) stg |= 1U << dphi;
+    }
+    return stg;
+}
+
+//_____________________________________________________________________________
+inline Bool_t AliMCInfoFastOR::IsSTGFired(UInt_t stgMask, Int_t dphiMin, Int_t dphiMax)
+{
+    // a distance d is the same coincidence as d%20 and as 20-d%20
+    for (Int_t dphi=dphiMin; dphi<=dphiMax; dphi++) {
+        Int_t dd = dphi%kNSectL0;
+        if (dd>kMaxDphi) dd = kNSectL0-dd;
+        if (stgMask & (1U << dd)) return kTRUE;
+    }
+    return kFALSE;
+}
+
+#endif
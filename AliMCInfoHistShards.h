@@ -0,0 +1,188 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoHistShards_H
+#define AliMCInfoHistShards_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "TH1F.h"
+#include "TList.h"
+#include "AliMCInfoPDGCounter.h"
+
+// 1D histograms filled through per-thread shards
+//
+// every histogram is booked once into the output list and gets one array
+// of integer bin counts per shard. a thread fills only its own shard, so
+// the fill path needs no lock. Flush adds the shard counts to the output
+// histograms and clears the shards; integer counts make this merge exact
+// and independent of the order in which the events were processed.
+// only integer-weight fills are supported. the statistics (mean, rms) of
+// the output histograms are recomputed from the bin contents at the flush,
+// contents already in an output histogram (a restored checkpoint) are kept.
+// pdg counters are sharded the same way, with one (pdg code -> count) map
+// per shard which Flush adds to the output AliMCInfoPDGCounter
+class AliMCInfoHistShards
+{
+    public:
+        enum { kMaxShards = 64 };
+
+                                AliMCInfoHistShards(Int_t nShards=1);
+
+        // book a histogram, add it to list and return its handle
+        Int_t                   Book(TList* list, const char* name, const char* title,
+                                    Int_t nbins, Double_t xmin, Double_t xmax);
+        TH1F*                   GetHistogram(Int_t id) const { return fHists[id].fHist; }
+
+        void                    Fill(Int_t id, Double_t x, ULong64_t n=1);
+
+        // book a pdg counter, add it to list and return its handle
+        Int_t                   BookCounter(TList* list, const char* name, const char* title);
+        AliMCInfoPDGCounter*    GetCounter(Int_t id) const { return fCounters[id].fCounter; }
+        void                    FillCounter(Int_t id, Int_t pdg);
+
+        void                    Flush();
+
+    private:
+        struct Hist {
+            TH1F*               fHist;          // output histogram (owned by the list)
+            Int_t               fNbins;         // binning
+            Double_t            fXmin;          // binning
+            Double_t            fXmax;          // binning
+            std::vector<std::vector<ULong64_t> > fShards;   // [shard][bin]
+            std::shared_ptr<std::atomic<ULong64_t> > fOverflow; // shared by surplus threads
+        };
+        typedef std::unordered_map<Int_t, Long64_t> CountMap;
+        struct Counter {
+            AliMCInfoPDGCounter* fCounter;      // output counter (owned by the list)
+            std::vector<std::shared_ptr<CountMap> > fShards;    // [shard], separate allocations
+            std::shared_ptr<CountMap> fOverflow;    // shared by surplus threads
+            std::shared_ptr<std::mutex> fOverflowLock;  // guards fOverflow
+        };
+        Int_t                   Shard();
+        Int_t                   FindBin(const Hist& hist, Double_t x) const;
+
+        Int_t                   fNShards;       // number of shards
+        std::vector<Hist>       fHists;         // booked histograms
+        std::vector<Counter>    fCounters;      // booked pdg counters
+};
+
+//_____________________________________________________________________________
+inline AliMCInfoHistShards::AliMCInfoHistShards(Int_t nShards)
+  : fNShards(nShards<1 ? 1 : (nShards>kMaxShards ? kMaxShards : nShards))
+  , fHists()
+  , fCounters()
+{
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoHistShards::Book(TList* list, const char* name, const char* title,
+    Int_t nbins, Double_t xmin, Double_t xmax)
+{
+    Hist hist;
+    hist.fHist  = new TH1F(name, title, nbins, xmin, xmax);
+    hist.fNbins = nbins;
+    hist.fXmin  = xmin;
+    hist.fXmax  = xmax;
+    // 8 spare words keep the shards of different threads off the same cache line
+    hist.fShards.assign(fNShards, std::vector<ULong64_t>(nbins+2+8, 0));
+    hist.fOverflow.reset(new std::atomic<ULong64_t>[nbins+2], std::default_delete<std::atomic<ULong64_t>[]>());
+    for (Int_t ii=0; ii<nbins+2; ii++) hist.fOverflow.get()[ii] = 0;
+    if (list) list->Add(hist.fHist);
+    fHists.push_back(hist);
+    return fHists.size()-1;
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoHistShards::Shard()
+{
+    // threads are numbered once per process, so that a thread has the same
+    // shard in every container. the first fNShards threads own a shard,
+    // further threads (-1) use the atomic overflow counters
+    static std::atomic<Int_t> nThreads(0);
+    static thread_local Int_t thread = nThreads++;
+    return thread<fNShards ? thread : -1;
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoHistShards::FindBin(const Hist& hist, Double_t x) const
+{
+    // same convention as TAxis::FindBin for fixed bins
+    if (x<hist.fXmin) return 0;
+    if (!(x<hist.fXmax)) return hist.fNbins+1;
+    return 1 + Int_t(hist.fNbins*(x-hist.fXmin)/(hist.fXmax-hist.fXmin));
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoHistShards::Fill(Int_t id, Double_t x, ULong64_t n)
+{
+    Hist& hist = fHists[id];
+    Int_t bin = FindBin(hist, x);
+    Int_t slot = Shard();
+    if (slot>=0) hist.fShards[slot][bin] += n;
+    else hist.fOverflow.get()[bin].fetch_add(n, std::memory_order_relaxed);
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoHistShards::BookCounter(TList* list, const char* name, const char* title)
+{
+    Counter counter;
+    counter.fCounter = new AliMCInfoPDGCounter(name, title);
+    for (Int_t slot=0; slot<fNShards; slot++) counter.fShards.push_back(std::make_shared<CountMap>());
+    counter.fOverflow = std::make_shared<CountMap>();
+    counter.fOverflowLock = std::make_shared<std::mutex>();
+    if (list) list->Add(counter.fCounter);
+    fCounters.push_back(counter);
+    return fCounters.size()-1;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoHistShards::FillCounter(Int_t id, Int_t pdg)
+{
+    Counter& counter = fCounters[id];
+    Int_t slot = Shard();
+    if (slot>=0) {
+        (*counter.fShards[slot])[pdg]++;
+    } else {
+        std::lock_guard<std::mutex> lock(*counter.fOverflowLock);
+        (*counter.fOverflow)[pdg]++;
+    }
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoHistShards::Flush()
+{
+    // must not run concurrently with Fill or FillCounter
+    for (UInt_t id=0; id<fHists.size(); id++) {
+        Hist& hist = fHists[id];
+        Bool_t changed = kFALSE;
+        for (Int_t bin=0; bin<hist.fNbins+2; bin++) {
+            ULong64_t sum = hist.fOverflow.get()[bin].exchange(0);
+            for (Int_t slot=0; slot<fNShards; slot++) {
+                sum += hist.fShards[slot][bin];
+                hist.fShards[slot][bin] = 0;
+            }
+            if (!sum) continue;
+            hist.fHist->AddBinContent(bin, sum);
+            changed = kTRUE;
+        }
+        if (changed) hist.fHist->ResetStats();
+    }
+    // the maps keep their buckets, the codes of an event recur in the next
+    for (UInt_t id=0; id<fCounters.size(); id++) {
+        Counter& counter = fCounters[id];
+        for (Int_t slot=0; slot<=fNShards; slot++) {
+            CountMap& counts = slot<fNShards ? *counter.fShards[slot] : *counter.fOverflow;
+            for (CountMap::const_iterator it=counts.begin(); it!=counts.end(); ++it)
+                counter.fCounter->Fill(it->first, it->second);
+            counts.clear();
+        }
+    }
+}
+
+#endif
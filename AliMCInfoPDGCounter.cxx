@@ -0,0 +1,113 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+/* AliMCInfoPDGCounter
+ *
+ * sparse counter of pdg codes, used as output object of AliAnalysisTaskMCInfo
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "TCollection.h"
+#include "TH1D.h"
+#include "AliMCInfoPDGCounter.h"
+
+ClassImp(AliMCInfoPDGCounter)
+
+//_____________________________________________________________________________
+AliMCInfoPDGCounter::AliMCInfoPDGCounter()
+  : TNamed()
+  , fCounts()
+  , fEntries(0)
+{
+    // default constructor, used for reading
+}
+//_____________________________________________________________________________
+AliMCInfoPDGCounter::AliMCInfoPDGCounter(const char* name, const char* title)
+  : TNamed(name, title)
+  , fCounts()
+  , fEntries(0)
+{
+}
+//_____________________________________________________________________________
+AliMCInfoPDGCounter::~AliMCInfoPDGCounter()
+{
+}
+//_____________________________________________________________________________
+Long64_t AliMCInfoPDGCounter::GetCount(Int_t pdg) const
+{
+    return const_cast<TExMap&>(fCounts).GetValue(Hash(pdg), pdg);
+}
+//_____________________________________________________________________________
+void AliMCInfoPDGCounter::Add(const AliMCInfoPDGCounter* other)
+{
+    if (!other) return;
+    TExMapIter iter(&other->fCounts);
+    Long64_t pdg, count;
+    while (iter.Next(pdg, count)) fCounts(Hash(pdg), pdg) += count;
+    fEntries += other->fEntries;
+}
+//_____________________________________________________________________________
+Long64_t AliMCInfoPDGCounter::Merge(TCollection* list)
+{
+    // called by the analysis manager and hadd
+    if (!list) return fEntries;
+    TIter next(list);
+    while (TObject* obj = next()) {
+        AliMCInfoPDGCounter* other = dynamic_cast<AliMCInfoPDGCounter*>(obj);
+        if (!other) {
+            printf("<E> AliMCInfoPDGCounter::Merge: cannot merge a %s\n", obj->ClassName());
+            return -1;
+        }
+        Add(other);
+    }
+    return fEntries;
+}
+//_____________________________________________________________________________
+void AliMCInfoPDGCounter::Clear(Option_t*)
+{
+    fCounts.Delete();
+    fEntries = 0;
+}
+//_____________________________________________________________________________
+void AliMCInfoPDGCounter::Print(Option_t*) const
+{
+    printf("%s: %lld entries, %i pdg codes\n", GetName(), fEntries, GetNCodes());
+    TH1D* hist = CreateHistogram("tmp");
+    for (Int_t ii=1; ii<=hist->GetNbinsX(); ii++)
+        printf("  %12s %lld\n", hist->GetXaxis()->GetBinLabel(ii), (Long64_t)hist->GetBinContent(ii));
+    delete hist;
+}
+//_____________________________________________________________________________
+TH1D* AliMCInfoPDGCounter::CreateHistogram(const char* name) const
+{
+    std::vector<std::pair<Long64_t, Long64_t> > counts;
+    counts.reserve(GetNCodes());
+    TExMapIter iter(&fCounts);
+    Long64_t pdg, count;
+    while (iter.Next(pdg, count)) counts.push_back(std::make_pair(pdg, count));
+    std::sort(counts.begin(), counts.end());
+
+    Int_t nbins = counts.size()>0 ? counts.size() : 1;
+    TH1D* hist = new TH1D(name, GetTitle(), nbins, 0, nbins);
+    hist->SetDirectory(0);
+    for (UInt_t ii=0; ii<counts.size(); ii++) {
+        hist->GetXaxis()->SetBinLabel(ii+1, Form("%lld", counts[ii].first));
+        hist->SetBinContent(ii+1, counts[ii].second);
+    }
+    hist->SetEntries(fEntries);
+    return hist;
+}
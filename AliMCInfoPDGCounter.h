@@ -0,0 +1,53 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoPDGCounter_H
+#define AliMCInfoPDGCounter_H
+
+#include "TNamed.h"
+#include "TExMap.h"
+
+class TCollection;
+class TH1D;
+
+// exact counts per pdg code
+//
+// a hash map (pdg code -> count) replaces a fixed-bin histogram, so any
+// code (negative, nuclei) is counted exactly and only the codes which
+// occur take space. Merge adds the maps code by code, its cost grows
+// with the number of distinct codes and not with a binning
+class AliMCInfoPDGCounter : public TNamed
+{
+    public:
+                                AliMCInfoPDGCounter();
+                                AliMCInfoPDGCounter(const char* name, const char* title);
+        virtual                 ~AliMCInfoPDGCounter();
+
+        void                    Fill(Int_t pdg, Long64_t n=1)   { fCounts(Hash(pdg), pdg) += n; fEntries += n; }
+        Long64_t                GetCount(Int_t pdg) const;
+        Int_t                   GetNCodes() const               { return fCounts.GetEntries(); }
+        Long64_t                GetEntries() const              { return fEntries; }
+
+        void                    Add(const AliMCInfoPDGCounter* other);
+        Long64_t                Merge(TCollection* list);
+        virtual void            Clear(Option_t* option="");
+        virtual void            Print(Option_t* option="") const;
+
+        // histogram with one bin per code in ascending order, labelled with
+        // the code; owned by the caller
+        TH1D*                   CreateHistogram(const char* name) const;
+
+    private:
+        static ULong64_t        Hash(Int_t pdg)                 { return (ULong64_t)(Long64_t)pdg; }
+
+        TExMap                  fCounts;        // pdg code -> count
+        Long64_t                fEntries;       // sum of all counts
+
+        AliMCInfoPDGCounter(const AliMCInfoPDGCounter&);
+        AliMCInfoPDGCounter& operator=(const AliMCInfoPDGCounter&);
+
+        ClassDef(AliMCInfoPDGCounter, 1);
+};
+
+#endif
@@ -0,0 +1,138 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoSkim_H
+#define AliMCInfoSkim_H
+
+#include "TLorentzVector.h"
+#include "TTree.h"
+
+// compact record of a selected CEP event
+//
+// one tree entry per accepted event and track-cut configuration, also for
+// events without MC information. every quantity is a branch of its own, so
+// downstream studies read only the columns they need. the MC quantities
+// (labels, pdg codes, X system) are only filled for events with MC
+// information (hasMC), else the label arrays are empty and X is zero.
+// the entries are buffered in memory and written in clusters of
+// kClusterBytes
+class AliMCInfoSkim
+{
+    public:
+        enum { kMaxTracks = 8, kClusterBytes = 4000000 };
+
+                                AliMCInfoSkim();
+
+        TTree*                  CreateTree(const char* name);
+
+        void                    BeginEvent(Int_t run, ULong64_t eventId, Int_t config,
+                                    UInt_t stgMask, const Short_t* nFiredChips, Bool_t hasMC);
+        // label and mcPdg are ignored for an event without MC information
+        void                    AddTrack(Double_t px, Double_t py, Double_t pz, Short_t charge,
+                                    Int_t status, Int_t label=0, Int_t mcPdg=0);
+        void                    SetX(const TLorentzVector& lv);
+        void                    Fill()                  { if (fTree) fTree->Fill(); }
+
+    private:
+        TTree*                  fTree;                  // output tree (owned by the output file)
+        Int_t                   fRun;                   // run number
+        ULong64_t               fEventId;               // AliESDHeader::GetEventIdAsLong
+        Int_t                   fConfig;                // track-cut configuration
+        UInt_t                  fSTGMask;               // STG dphi mask
+        Short_t                 fNFiredChips[4];        // SPD layers, FastOR layers
+        Bool_t                  fHasMC;                 // MC information available
+        Int_t                   fNTracks;               // selected tracks
+        Int_t                   fNLabels;               // fNTracks with MC information, else 0
+        Float_t                 fPx[kMaxTracks];        // track momentum
+        Float_t                 fPy[kMaxTracks];        // track momentum
+        Float_t                 fPz[kMaxTracks];        // track momentum
+        Short_t                 fCharge[kMaxTracks];    // track charge
+        Int_t                   fStatus[kMaxTracks];    // track status bits
+        Int_t                   fLabel[kMaxTracks];     // AliESDtrack::GetLabel, <0: fake track
+        Int_t                   fMCPdg[kMaxTracks];     // pdg code of particle fLabel, 0: not in the stack
+        Float_t                 fX[4];                  // MC X system (px, py, pz, E)
+};
+
+//_____________________________________________________________________________
+inline AliMCInfoSkim::AliMCInfoSkim()
+  : fTree(0)
+  , fRun(0)
+  , fEventId(0)
+  , fConfig(0)
+  , fSTGMask(0)
+  , fHasMC(kFALSE)
+  , fNTracks(0)
+  , fNLabels(0)
+{
+    for (Int_t ii=0; ii<4; ii++) fNFiredChips[ii] = 0;
+    for (Int_t ii=0; ii<4; ii++) fX[ii] = 0;
+}
+
+//_____________________________________________________________________________
+inline TTree* AliMCInfoSkim::CreateTree(const char* name)
+{
+    // the current directory has to be the output file
+    fTree = new TTree(name, "selected CEP events");
+    fTree->Branch("run",        &fRun,          "run/I");
+    fTree->Branch("eventId",    &fEventId,      "eventId/l");
+    fTree->Branch("config",     &fConfig,       "config/I");
+    fTree->Branch("stgMask",    &fSTGMask,      "stgMask/i");
+    fTree->Branch("nFiredChips", fNFiredChips,  "nFiredChips[4]/S");
+    fTree->Branch("hasMC",      &fHasMC,        "hasMC/O");
+    fTree->Branch("nTracks",    &fNTracks,      "nTracks/I");
+    fTree->Branch("px",         fPx,            "px[nTracks]/F");
+    fTree->Branch("py",         fPy,            "py[nTracks]/F");
+    fTree->Branch("pz",         fPz,            "pz[nTracks]/F");
+    fTree->Branch("charge",     fCharge,        "charge[nTracks]/S");
+    fTree->Branch("status",     fStatus,        "status[nTracks]/I");
+    fTree->Branch("nLabels",    &fNLabels,      "nLabels/I");
+    fTree->Branch("label",      fLabel,         "label[nLabels]/I");
+    fTree->Branch("mcPdg",      fMCPdg,         "mcPdg[nLabels]/I");
+    fTree->Branch("X",          fX,             "X[4]/F");
+    fTree->SetAutoFlush(-kClusterBytes);
+    return fTree;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoSkim::BeginEvent(Int_t run, ULong64_t eventId, Int_t config,
+    UInt_t stgMask, const Short_t* nFiredChips, Bool_t hasMC)
+{
+    fRun     = run;
+    fEventId = eventId;
+    fConfig  = config;
+    fSTGMask = stgMask;
+    for (Int_t ii=0; ii<4; ii++) fNFiredChips[ii] = nFiredChips[ii];
+    fHasMC   = hasMC;
+    fNTracks = 0;
+    fNLabels = 0;
+    for (Int_t ii=0; ii<4; ii++) fX[ii] = 0;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoSkim::AddTrack(Double_t px, Double_t py, Double_t pz, Short_t charge,
+    Int_t status, Int_t label, Int_t mcPdg)
+{
+    if (fNTracks>=kMaxTracks) return;
+    fPx[fNTracks]     = px;
+    fPy[fNTracks]     = py;
+    fPz[fNTracks]     = pz;
+    fCharge[fNTracks] = charge;
+    fStatus[fNTracks] = status;
+    fNTracks++;
+    if (!fHasMC) return;
+    fLabel[fNLabels]  = label;
+    fMCPdg[fNLabels]  = mcPdg;
+    fNLabels++;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoSkim::SetX(const TLorentzVector& lv)
+{
+    fX[0] = lv.Px();
+    fX[1] = lv.Py();
+    fX[2] = lv.Pz();
+    fX[3] = lv.E();
+}
+
+#endif
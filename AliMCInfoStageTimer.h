@@ -0,0 +1,166 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoStageTimer_H
+#define AliMCInfoStageTimer_H
+
+// per-stage timing and counters of the event loop
+//
+// a Scope object measures one execution of a stage and records whether the
+// event passed it. the counters are plain members of the task's own timer,
+// so no locking is involved. time is taken from the TSC on x86 (converted
+// to ns with a calibration against the steady clock) and from the steady
+// clock elsewhere. compile with -DMCINFO_TIMING=0 to remove all of it: the
+// scopes are then empty and the task creates neither the timer nor its
+// histograms. Now() stays available (from the steady clock) for callers
+// which need a time of their own, e.g. the adaptive cut order
+#ifndef MCINFO_TIMING
+#define MCINFO_TIMING 1
+#endif
+
+#include <chrono>
+#include <vector>
+#if MCINFO_TIMING && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define MCINFO_TIMING_TSC 1
+#endif
+
+#include "TH1D.h"
+#include "TList.h"
+#include "TString.h"
+
+class AliMCInfoStageTimer
+{
+    public:
+                                AliMCInfoStageTimer(Int_t nStages);
+
+        void                    SetStageName(Int_t stage, const char* name) { fNames[stage] = name; }
+        // one execution of a stage
+        void                    Add(Int_t stage, ULong64_t ticks, Bool_t passed);
+        static ULong64_t        Now();
+
+        // histograms of calls, rejections and total time [ns] per stage.
+        // FillHistograms adds the counts since its last call, so that counts
+        // already in the histograms (a restored checkpoint) are kept, and
+        // recomputes their statistics from the bin contents
+        void                    CreateHistograms(TList* list);
+        void                    FillHistograms();
+
+        class Scope
+        {
+            public:
+#if MCINFO_TIMING
+                                Scope(AliMCInfoStageTimer* timer, Int_t stage)
+                                  : fTimer(timer), fStage(stage), fPassed(kTRUE), fStart(timer ? Now() : 0) {}
+                               ~Scope() { if (fTimer) fTimer->Add(fStage, Now()-fStart, fPassed); }
+                void            SetPassed(Bool_t passed) { fPassed = passed; }
+            private:
+                AliMCInfoStageTimer* fTimer;
+                Int_t           fStage;
+                Bool_t          fPassed;
+                ULong64_t       fStart;
+#else
+                                Scope(AliMCInfoStageTimer*, Int_t) {}
+                void            SetPassed(Bool_t) {}
+#endif
+        };
+
+    private:
+        Double_t                NsPerTick() const;
+
+        std::vector<TString>    fNames;         // stage names
+        std::vector<Long64_t>   fCalls;         // executions per stage
+        std::vector<Long64_t>   fRejected;      // rejected events per stage
+        std::vector<ULong64_t>  fTicks;         // time per stage
+        ULong64_t               fTick0;         // calibration start
+        std::chrono::steady_clock::time_point fTime0;   // calibration start
+        TH1D*                   fHCalls;        // output (owned by the list)
+        TH1D*                   fHRejected;     // output (owned by the list)
+        TH1D*                   fHTime;         // output (owned by the list)
+};
+
+//_____________________________________________________________________________
+inline AliMCInfoStageTimer::AliMCInfoStageTimer(Int_t nStages)
+  : fNames(nStages)
+  , fCalls(nStages, 0)
+  , fRejected(nStages, 0)
+  , fTicks(nStages, 0)
+  , fTick0(Now())
+  , fTime0(std::chrono::steady_clock::now())
+  , fHCalls(0)
+  , fHRejected(0)
+  , fHTime(0)
+{
+    for (Int_t ii=0; ii<nStages; ii++) fNames[ii] = Form("stage%i", ii);
+}
+
+//_____________________________________________________________________________
+inline ULong64_t AliMCInfoStageTimer::Now()
+{
+#if defined(MCINFO_TIMING_TSC)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoStageTimer::Add(Int_t stage, ULong64_t ticks, Bool_t passed)
+{
+    fCalls[stage]++;
+    fTicks[stage] += ticks;
+    if (!passed) fRejected[stage]++;
+}
+
+//_____________________________________________________________________________
+inline Double_t AliMCInfoStageTimer::NsPerTick() const
+{
+#if defined(MCINFO_TIMING_TSC)
+    Double_t ns = std::chrono::duration<Double_t, std::nano>(
+        std::chrono::steady_clock::now() - fTime0).count();
+    ULong64_t ticks = Now() - fTick0;
+    return ticks>0 ? ns/ticks : 0.;
+#else
+    return 1.;
+#endif
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoStageTimer::CreateHistograms(TList* list)
+{
+    Int_t n = fNames.size();
+    fHCalls    = new TH1D("fStageCalls",    "fStageCalls",    n, -0.5, n-0.5);
+    fHRejected = new TH1D("fStageRejected", "fStageRejected", n, -0.5, n-0.5);
+    fHTime     = new TH1D("fStageTime",     "fStageTime;;time [ns]", n, -0.5, n-0.5);
+    for (Int_t ii=0; ii<n; ii++) {
+        fHCalls->GetXaxis()->SetBinLabel(ii+1, fNames[ii].Data());
+        fHRejected->GetXaxis()->SetBinLabel(ii+1, fNames[ii].Data());
+        fHTime->GetXaxis()->SetBinLabel(ii+1, fNames[ii].Data());
+    }
+    list->Add(fHCalls);
+    list->Add(fHRejected);
+    list->Add(fHTime);
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoStageTimer::FillHistograms()
+{
+    // at every checkpoint and at the end of the event loop, the histograms
+    // are then written or merged
+    if (!fHTime) return;
+    Double_t nsPerTick = NsPerTick();
+    for (UInt_t ii=0; ii<fNames.size(); ii++) {
+        fHCalls->AddBinContent(ii+1, fCalls[ii]);
+        fHRejected->AddBinContent(ii+1, fRejected[ii]);
+        fHTime->AddBinContent(ii+1, fTicks[ii]*nsPerTick);
+        fCalls[ii] = fRejected[ii] = 0;
+        fTicks[ii] = 0;
+    }
+    fHCalls->ResetStats();
+    fHRejected->ResetStats();
+    fHTime->ResetStats();
+}
+
+#endif
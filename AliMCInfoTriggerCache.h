@@ -0,0 +1,156 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoTriggerCache_H
+#define AliMCInfoTriggerCache_H
+
+#include "AliAnalysisManager.h"
+#include "AliESDEvent.h"
+#include "AliTriggerAnalysis.h"
+
+// per-event cache of offline trigger decisions
+//
+// one instance per process (and thus per AliAnalysisManager, also on every
+// PROOF worker) is shared by all tasks of the train. the tasks register the
+// triggers they need with Request(); a trigger is evaluated at its first
+// query in an event and its decision is kept in a bitmask, later queries of
+// the same trigger in the same event are served from the mask. triggers
+// nobody asks for in an event are never decoded. the event is
+// identified by the manager entry and the ESD header (run, period, orbit,
+// bunch crossing). the decisions depend on the AliTriggerAnalysis settings,
+// so the AliTriggerAnalysis object is part of the key: only queries through
+// the same object share decisions, a query through another one starts the
+// event anew. tasks which want to share the decisions share one object.
+// the hit and miss counters cover the whole process; a task that needs its
+// own share passes the optional hit flag to IsFired
+class AliMCInfoTriggerCache
+{
+    public:
+        enum { kMaxTriggers = 32 };
+
+        static AliMCInfoTriggerCache* Instance();
+
+        void                    Request(Int_t trigger);
+        Bool_t                  IsFired(AliTriggerAnalysis* ana, AliESDEvent* esd, Int_t trigger,
+                                        Bool_t* hit=0);
+
+        Long64_t                GetNHits() const        { return fNHits; }
+        Long64_t                GetNMisses() const      { return fNMisses; }
+
+    private:
+                                AliMCInfoTriggerCache();
+        Int_t                   Slot(Int_t trigger) const;
+        Bool_t                  IsCurrent(const AliTriggerAnalysis* ana, AliESDEvent* esd) const;
+        static ULong64_t        EventId(AliESDEvent* esd);
+
+        Int_t                   fNTriggers;             // registered triggers
+        Int_t                   fTriggers[kMaxTriggers];// AliTriggerAnalysis::Trigger per slot
+        UInt_t                  fEvaluated;             // slots evaluated for the cached event
+        UInt_t                  fFired;                 // decisions of the cached event
+        const AliTriggerAnalysis* fAna;                 // settings of the cached decisions
+        const AliESDEvent*      fESD;                   // cached event
+        Long64_t                fEntry;                 // cached event
+        Int_t                   fRun;                   // cached event
+        ULong64_t               fEventId;               // cached event
+        Long64_t                fNHits;                 // queries served from the cache
+        Long64_t                fNMisses;               // queries which needed a decoding
+};
+
+//_____________________________________________________________________________
+inline AliMCInfoTriggerCache::AliMCInfoTriggerCache()
+  : fNTriggers(0)
+  , fEvaluated(0)
+  , fFired(0)
+  , fAna(0)
+  , fESD(0)
+  , fEntry(-1)
+  , fRun(-1)
+  , fEventId(0)
+  , fNHits(0)
+  , fNMisses(0)
+{
+    for (Int_t ii=0; ii<kMaxTriggers; ii++) fTriggers[ii] = 0;
+}
+
+//_____________________________________________________________________________
+inline AliMCInfoTriggerCache* AliMCInfoTriggerCache::Instance()
+{
+    static AliMCInfoTriggerCache cache;
+    return &cache;
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoTriggerCache::Slot(Int_t trigger) const
+{
+    for (Int_t ii=0; ii<fNTriggers; ii++) if (fTriggers[ii]==trigger) return ii;
+    return -1;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoTriggerCache::Request(Int_t trigger)
+{
+    if (Slot(trigger)>=0) return;
+    if (fNTriggers>=kMaxTriggers) {
+        printf("<E> AliMCInfoTriggerCache: at most %i triggers can be cached!\n", kMaxTriggers);
+        return;
+    }
+    fTriggers[fNTriggers++] = trigger;
+}
+
+//_____________________________________________________________________________
+inline ULong64_t AliMCInfoTriggerCache::EventId(AliESDEvent* esd)
+{
+    // period, orbit and bunch crossing
+    return esd->GetHeader()->GetEventIdAsLong();
+}
+
+//_____________________________________________________________________________
+inline Bool_t AliMCInfoTriggerCache::IsCurrent(const AliTriggerAnalysis* ana, AliESDEvent* esd) const
+{
+    AliAnalysisManager* mgr = AliAnalysisManager::GetAnalysisManager();
+    Long64_t entry = mgr ? mgr->GetCurrentEntry() : -1;
+    return ana==fAna && esd==fESD && entry==fEntry && esd->GetRunNumber()==fRun && EventId(esd)==fEventId;
+}
+
+//_____________________________________________________________________________
+inline Bool_t AliMCInfoTriggerCache::IsFired(AliTriggerAnalysis* ana, AliESDEvent* esd, Int_t trigger,
+                                             Bool_t* hit)
+{
+    if (hit) *hit = kFALSE;
+    Int_t slot = Slot(trigger);
+    if (slot<0) {
+        Request(trigger);
+        slot = Slot(trigger);
+        // no free slot: decode without caching
+        if (slot<0) {
+            fNMisses++;
+            return ana->IsOfflineTriggerFired(esd, (AliTriggerAnalysis::Trigger)trigger);
+        }
+    }
+
+    if (!IsCurrent(ana, esd)) {
+        // new event or other settings: forget the previous decisions
+        AliAnalysisManager* mgr = AliAnalysisManager::GetAnalysisManager();
+        fAna       = ana;
+        fESD       = esd;
+        fEntry     = mgr ? mgr->GetCurrentEntry() : -1;
+        fRun       = esd->GetRunNumber();
+        fEventId   = EventId(esd);
+        fEvaluated = 0;
+        fFired     = 0;
+    }
+    if (fEvaluated & (1U << slot)) {
+        fNHits++;
+        if (hit) *hit = kTRUE;
+    } else {
+        // first query of this trigger in the event
+        if (ana->IsOfflineTriggerFired(esd, (AliTriggerAnalysis::Trigger)trigger))
+            fFired |= 1U << slot;
+        fEvaluated |= 1U << slot;
+        fNMisses++;
+    }
+    return (fFired >> slot) & 1;
+}
+
+#endif
@@ -0,0 +1,222 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliMCInfoTruthIndex_H
+#define AliMCInfoTruthIndex_H
+
+#include <vector>
+
+#include "TLorentzVector.h"
+#include "TMath.h"
+#include "TParticle.h"
+#include "TParticlePDG.h"
+#include "AliStack.h"
+
+// compact per-event index of the MC truth
+//
+// built in one pass over AliStack, the kinematics and the family relations
+// of all particles are kept in plain arrays (structure of arrays) together
+// with a mother -> children adjacency table. all later look-ups of the
+// event (X system, mothers, label matching, EMCal candidates) then avoid
+// the virtual TParticle access. the arrays keep their capacity from event
+// to event
+class AliMCInfoTruthIndex
+{
+    public:
+        enum { kUnknownCharge = -99 };  // pdg code not in the particle database
+
+                                AliMCInfoTruthIndex(Int_t capacity=1024);
+
+        void                    Build(AliStack* stack);
+
+        Int_t                   GetN() const            { return fN; }
+        Int_t                   GetNPrimary() const     { return fNPrimary; }
+        Double_t                GetPx(Int_t ii) const   { return fPx[ii]; }
+        Double_t                GetPy(Int_t ii) const   { return fPy[ii]; }
+        Double_t                GetPz(Int_t ii) const   { return fPz[ii]; }
+        Double_t                GetE(Int_t ii) const    { return fE[ii]; }
+        Int_t                   GetPdg(Int_t ii) const  { return fPdg[ii]; }
+        // charge in units of |e|/3, kUnknownCharge if the pdg code is unknown
+        Int_t                   GetCharge(Int_t ii) const { return fCharge[ii]; }
+        Double_t                GetVx(Int_t ii) const   { return fVx[ii]; }
+        Double_t                GetVy(Int_t ii) const   { return fVy[ii]; }
+        Double_t                GetVz(Int_t ii) const   { return fVz[ii]; }
+        Int_t                   GetMother(Int_t ii) const { return fMother[ii]; }
+        Int_t                   GetFirstDaughter(Int_t ii) const { return fFirstDaughter[ii]; }
+        Int_t                   GetLastDaughter(Int_t ii) const { return fLastDaughter[ii]; }
+        Bool_t                  IsValid(Int_t ii) const { return ii>=0 && ii<fN; }
+
+        // particles with GetMother(0)==ii, in stack order
+        Int_t                   GetNChildren(Int_t ii) const
+                                    { return fChildOffset[ii+1]-fChildOffset[ii]; }
+        const Int_t*            GetChildren(Int_t ii) const
+                                    { return fChildren.data() + fChildOffset[ii]; }
+
+        // first particle of the mother chain of ii (ii itself if it has no
+        // mother)
+        Int_t                   GetAncestor(Int_t ii) const;
+        // can particle ii, moving from its production vertex on a helix
+        // around z, cross the cylinder of the radius within |z|<=zmax
+        Bool_t                  CanReachCylinder(Int_t ii, Double_t radius, Double_t zmax) const;
+        void                    Momentum(Int_t ii, TLorentzVector& lv) const
+                                    { lv.SetPxPyPzE(fPx[ii], fPy[ii], fPz[ii], fE[ii]); }
+        // X system of a Pythia 106 event: particle 4 and the later primaries
+        // which come directly from particle 0, (0,0,0,0) for a short stack
+        void                    XMomentum(TLorentzVector& lv) const;
+
+    private:
+        Int_t                   fN;             // particles in the stack
+        Int_t                   fNPrimary;      // primary particles
+        std::vector<Double_t>   fPx;            // momentum
+        std::vector<Double_t>   fPy;            // momentum
+        std::vector<Double_t>   fPz;            // momentum
+        std::vector<Double_t>   fE;             // energy
+        std::vector<Int_t>      fPdg;           // pdg code
+        std::vector<Short_t>    fCharge;        // charge [|e|/3]
+        std::vector<Double_t>   fVx;            // production vertex
+        std::vector<Double_t>   fVy;            // production vertex
+        std::vector<Double_t>   fVz;            // production vertex
+        std::vector<Int_t>      fMother;        // first mother, -1 if none
+        std::vector<Int_t>      fFirstDaughter; // as in TParticle
+        std::vector<Int_t>      fLastDaughter;  // as in TParticle
+        std::vector<Int_t>      fChildOffset;   // children of ii: [fChildOffset[ii], fChildOffset[ii+1])
+        std::vector<Int_t>      fChildren;      // children grouped by mother
+};
+
+//_____________________________________________________________________________
+inline AliMCInfoTruthIndex::AliMCInfoTruthIndex(Int_t capacity)
+  : fN(0)
+  , fNPrimary(0)
+  , fPx()
+  , fPy()
+  , fPz()
+  , fE()
+  , fPdg()
+  , fCharge()
+  , fVx()
+  , fVy()
+  , fVz()
+  , fMother()
+  , fFirstDaughter()
+  , fLastDaughter()
+  , fChildOffset()
+  , fChildren()
+{
+    fPx.reserve(capacity);
+    fPy.reserve(capacity);
+    fPz.reserve(capacity);
+    fE.reserve(capacity);
+    fPdg.reserve(capacity);
+    fCharge.reserve(capacity);
+    fVx.reserve(capacity);
+    fVy.reserve(capacity);
+    fVz.reserve(capacity);
+    fMother.reserve(capacity);
+    fFirstDaughter.reserve(capacity);
+    fLastDaughter.reserve(capacity);
+    fChildOffset.reserve(capacity+1);
+    fChildren.reserve(capacity);
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoTruthIndex::Build(AliStack* stack)
+{
+    fN = stack ? stack->GetNtrack() : 0;
+    fNPrimary = stack ? stack->GetNprimary() : 0;
+    fPx.resize(fN);
+    fPy.resize(fN);
+    fPz.resize(fN);
+    fE.resize(fN);
+    fPdg.resize(fN);
+    fCharge.resize(fN);
+    fVx.resize(fN);
+    fVy.resize(fN);
+    fVz.resize(fN);
+    fMother.resize(fN);
+    fFirstDaughter.resize(fN);
+    fLastDaughter.resize(fN);
+    fChildOffset.assign(fN+1, 0);
+    fChildren.resize(fN);
+
+    // the only pass over the stack
+    for (Int_t ii=0; ii<fN; ii++) {
+        TParticle* part = stack->Particle(ii);
+        fPx[ii] = part->Px();
+        fPy[ii] = part->Py();
+        fPz[ii] = part->Pz();
+        fE[ii]  = part->Energy();
+        fPdg[ii] = part->GetPdgCode();
+        // TParticle keeps the database entry after the first look-up
+        TParticlePDG* pdg = part->GetPDG();
+        fCharge[ii] = pdg ? (Short_t)pdg->Charge() : (Short_t)kUnknownCharge;
+        fVx[ii] = part->Vx();
+        fVy[ii] = part->Vy();
+        fVz[ii] = part->Vz();
+        Int_t mother = part->GetMother(0);
+        fMother[ii] = (mother>=0 && mother<fN) ? mother : -1;
+        fFirstDaughter[ii] = part->GetFirstDaughter();
+        fLastDaughter[ii] = part->GetLastDaughter();
+        if (fMother[ii]>=0) fChildOffset[fMother[ii]+1]++;
+    }
+
+    // adjacency table: count (above), prefix sum, scatter. the backward
+    // scatter keeps the children in stack order and leaves fChildOffset[m+1]
+    // at the begin of the children of m, which is then shifted into place
+    Int_t nChildren = 0;
+    for (Int_t ii=0; ii<fN; ii++) {
+        nChildren += fChildOffset[ii+1];
+        fChildOffset[ii+1] = nChildren;
+    }
+    for (Int_t ii=fN-1; ii>=0; ii--) {
+        if (fMother[ii]>=0) fChildren[--fChildOffset[fMother[ii]+1]] = ii;
+    }
+    for (Int_t ii=0; ii<fN; ii++) fChildOffset[ii] = fChildOffset[ii+1];
+    fChildOffset[fN] = nChildren;
+}
+
+//_____________________________________________________________________________
+inline Int_t AliMCInfoTruthIndex::GetAncestor(Int_t ii) const
+{
+    // the loop is bounded by fN in case of a corrupted (cyclic) history
+    for (Int_t nstep=0; nstep<fN && fMother[ii]>=0; nstep++) ii = fMother[ii];
+    return ii;
+}
+
+//_____________________________________________________________________________
+inline void AliMCInfoTruthIndex::XMomentum(TLorentzVector& lv) const
+{
+    lv.SetPxPyPzE(0, 0, 0, 0);
+    if (fN<=4) return;
+    Momentum(4, lv);
+    // the children of particle 0 are in stack order
+    TLorentzVector lvtmp;
+    const Int_t* children = GetChildren(0);
+    for (Int_t ii=0; ii<GetNChildren(0); ii++) {
+        if (children[ii]<5) continue;
+        if (children[ii]>=fNPrimary) break;
+        Momentum(children[ii], lvtmp);
+        lv += lvtmp;
+    }
+}
+
+//_____________________________________________________________________________
+inline Bool_t AliMCInfoTruthIndex::CanReachCylinder(Int_t ii, Double_t radius, Double_t zmax) const
+{
+    // in a solenoidal field pz/pt is constant along the track and z grows
+    // linearly with the transverse path length s. from the production radius
+    // rv the cylinder is at least s0 = radius-rv away, so z takes the values
+    // vz + pz/pt*s, s >= s0. energy loss and scattering are neglected, the
+    // caller adds a margin to radius and zmax
+    Double_t rv = TMath::Sqrt(fVx[ii]*fVx[ii] + fVy[ii]*fVy[ii]);
+    if (rv>=radius) return kTRUE;
+    Double_t pt = TMath::Sqrt(fPx[ii]*fPx[ii] + fPy[ii]*fPy[ii]);
+    if (pt<=0.) return kFALSE;
+    Double_t slope = fPz[ii]/pt;
+    Double_t z0 = fVz[ii] + slope*(radius-rv);
+    if (slope>0.) return z0<=zmax;
+    if (slope<0.) return z0>=-zmax;
+    return z0>=-zmax && z0<=zmax;
+}
+
+#endif
@@ -0,0 +1,45 @@
+// the sector-loop evaluation of the FastOR map which AliMCInfoFastOR
+// replaced, kept as the reference of testFastOR.cxx and benchFastOR.cxx
+#ifndef BENCH_FastORReference_H
+#define BENCH_FastORReference_H
+
+#include "TBits.h"
+
+//_____________________________________________________________________________
+// code from Evgeny Kryshen, as AliAnalysisTaskMCInfo::IsSTGFired before
+// the bit-parallel kernel
+inline Bool_t ReferenceIsSTGFired(const TBits* fFOmap, Int_t dphiMin, Int_t dphiMax)
+{
+  Bool_t stg = kFALSE;
+
+  if (!fFOmap) return stg;
+
+  Int_t n1 = fFOmap->CountBits(400);
+  Int_t n0 = fFOmap->CountBits()-n1;
+  if (n0<1 || n1<1) return stg;
+
+  Bool_t l0[20]={0};
+  Bool_t l1[40]={0};
+  Bool_t phi[20]={0};
+  for (Int_t i=0;   i< 400; ++i) if (fFOmap->TestBitNumber(i)) l0[      i/20] = 1;
+  for (Int_t i=400; i<1200; ++i) if (fFOmap->TestBitNumber(i)) l1[(i-400)/20] = 1;
+  for (Int_t i=0; i<20; ++i) phi[i] = l0[i] & (l1[(2*i)%40] | l1[(2*i+1)%40] | l1[(2*i+2)%40] | l1[(2*i+39)%40]);
+  for (Int_t dphi=dphiMin;dphi<=dphiMax;dphi++) {
+    for (Int_t i=0; i<20; ++i) {
+      stg |= phi[i] & phi[(i+dphi)%20];
+    }
+  }
+
+  return stg;
+}
+
+//_____________________________________________________________________________
+// fired chips of the inner and outer layer, as counted in UserExec before
+inline void ReferenceFiredChips(const TBits& foMap, Short_t& nChipsL0, Short_t& nChipsL1)
+{
+  nChipsL0 = nChipsL1 = 0;
+  for (Int_t ii=0;    ii<400; ii++) nChipsL0 += foMap[ii]>0 ? 1 : 0;
+  for (Int_t ii=400; ii<1200; ii++) nChipsL1 += foMap[ii]>0 ? 1 : 0;
+}
+
+#endif
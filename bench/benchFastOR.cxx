@@ -0,0 +1,60 @@
+// micro-benchmark of AliMCInfoFastOR against the sector-loop reference
+//
+//   g++ -O2 -std=c++11 -Istand-ins -I.. benchFastOR.cxx -o benchFastOR
+//   ./benchFastOR [nEvents] [occupancy]
+//
+// per event the reference did one IsSTGFired call per sector distance
+// 0..10 and counted the fired chips bit by bit; the kernel evaluates the
+// map once. the result is printed as JSON
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "TBits.h"
+#include "AliMCInfoFastOR.h"
+#include "FastORReference.h"
+
+//_____________________________________________________________________________
+int main(int argc, char** argv)
+{
+    Long64_t nEvents = argc>1 ? atoll(argv[1]) : 200000;
+    Double_t occupancy = argc>2 ? atof(argv[2]) : 0.01;
+    const Int_t nPool = 1000;
+
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<Double_t> flat(0., 1.);
+    std::vector<TBits> pool(nPool, TBits(AliMCInfoFastOR::kNChips));
+    for (Int_t imap=0; imap<nPool; imap++)
+        for (Int_t ii=0; ii<AliMCInfoFastOR::kNChips; ii++)
+            if (flat(rng)<occupancy) pool[imap].SetBitNumber(ii);
+
+    UInt_t checksum[2] = {0, 0};
+    Double_t ns[2];
+    for (Int_t version=0; version<2; version++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (Long64_t iev=0; iev<nEvents; iev++) {
+            const TBits& foMap = pool[iev % nPool];
+            Short_t n0, n1;
+            UInt_t stgMask = 0;
+            if (version==0) {
+                for (Int_t dphi=0; dphi<=AliMCInfoFastOR::kMaxDphi; dphi++)
+                    stgMask |= ReferenceIsSTGFired(&foMap, dphi, dphi) ? (1U << dphi) : 0;
+                ReferenceFiredChips(foMap, n0, n1);
+            } else {
+                stgMask = AliMCInfoFastOR::Evaluate(&foMap, n0, n1);
+            }
+            checksum[version] += stgMask + n0 + n1;
+        }
+        ns[version] = std::chrono::duration<Double_t, std::nano>(std::chrono::steady_clock::now()-start).count();
+    }
+
+    printf("{\n  \"config\": {\"events\": %lld, \"occupancy\": %g},\n  \"stages\": [\n"
+        "    {\"name\": \"reference\", \"ns_per_event\": %.2f, \"events_per_s\": %.0f},\n"
+        "    {\"name\": \"AliMCInfoFastOR\", \"ns_per_event\": %.2f, \"events_per_s\": %.0f}\n"
+        "  ],\n  \"speedup\": %.1f,\n  \"same_result\": %s\n}\n",
+        nEvents, occupancy, ns[0]/nEvents, nEvents/ns[0]*1e9, ns[1]/nEvents, nEvents/ns[1]*1e9,
+        ns[0]/ns[1], checksum[0]==checksum[1] ? "true" : "false");
+    return checksum[0]==checksum[1] ? 0 : 1;
+}
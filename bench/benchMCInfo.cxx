@@ -0,0 +1,239 @@
+// standalone benchmark of the event selection and MC matching path of
+// AliAnalysisTaskMCInfo on synthetic events
+//
+// the kernels of the task (AliMCInfoFastOR, AliMCInfoEventBuffers,
+// AliMCInfoTruthIndex) are compiled against the stand-ins in stand-ins/,
+// so neither ROOT nor AliRoot is needed:
+//
+//   g++ -O2 -std=c++11 -Istand-ins -I.. benchMCInfo.cxx -o benchMCInfo
+//   ./benchMCInfo --events 200000 --occupancy 0.01 > bench.json
+//
+// a pool of events is generated up front, every stage then loops over the
+// pool until the requested number of events is reached. the stages are
+// timed as a whole, the result is printed as JSON (ns/event, events/s)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TArrayI.h"
+#include "TBits.h"
+#include "TLorentzVector.h"
+#include "TObjArray.h"
+#include "AliStack.h"
+#include "AliMCInfoFastOR.h"
+#include "AliMCInfoEventBuffers.h"
+#include "AliMCInfoTruthIndex.h"
+
+// parameters of the synthetic events
+struct BenchConfig
+{
+    Long64_t    nEvents;        // events per stage
+    Int_t       nPool;          // distinct events in the pool
+    Double_t    occupancy;      // probability of a fired FastOR chip
+    Int_t       nTracks;        // mean number of ESD tracks
+    Double_t    passFraction;   // tracks passing the track cuts
+    Int_t       nStack;         // mean number of MC particles
+    Int_t       nPrimary;       // primaries in the stack
+    UInt_t      seed;
+    UInt_t      TTmask;
+    UInt_t      TTpattern;
+};
+
+// one synthetic event
+struct BenchEvent
+{
+    TBits       foMap;          // FastOR chips
+    TArrayI     status;         // track status bits
+    TObjArray   tracks;         // placeholders of the ESD tracks
+    std::vector<Int_t> labels;  // MC label per track
+    AliStack    stack;          // MC truth
+    AliMCInfoTruthIndex truth;  // index of stack, built with the event
+
+    BenchEvent() : foMap(AliMCInfoFastOR::kNChips), truth(4096) {}
+};
+
+// database entries of the generated particles, charge in |e|/3
+static TParticlePDG gNeutral(0), gPositive(3), gNegative(-3);
+
+//_____________________________________________________________________________
+static void GenerateEvent(BenchEvent& ev, const BenchConfig& cfg, std::mt19937_64& rng)
+{
+    std::uniform_real_distribution<Double_t> flat(0., 1.);
+    std::normal_distribution<Double_t> gaus(0., 1.);
+    std::poisson_distribution<Int_t> nTracks(cfg.nTracks);
+    std::poisson_distribution<Int_t> nStack(cfg.nStack);
+
+    // FastOR map
+    ev.foMap.ResetAllBits();
+    for (Int_t ii=0; ii<AliMCInfoFastOR::kNChips; ii++)
+        if (flat(rng)<cfg.occupancy) ev.foMap.SetBitNumber(ii);
+
+    // MC stack: particle 0 is the mother of the primaries 4.. (the X system
+    // as GetXLorentzVector expects it), the secondaries hang below random
+    // earlier particles
+    Int_t nPart = nStack(rng);
+    if (nPart<cfg.nPrimary+1) nPart = cfg.nPrimary+1;
+    ev.stack.Reset(nPart, cfg.nPrimary);
+    for (Int_t ii=0; ii<nPart; ii++) {
+        Int_t mother = -1;
+        if (ii>=4 && ii<cfg.nPrimary) mother = flat(rng)<0.8 ? 0 : -1;
+        else if (ii>=cfg.nPrimary) mother = (Int_t)(flat(rng)*ii);
+        Double_t px = gaus(rng), py = gaus(rng), pz = 2*gaus(rng);
+        Double_t m = 0.13957;
+        Int_t pdg = flat(rng)<0.5 ? 211 : -211;
+        if (flat(rng)<0.2) { pdg = 22; m = 0.; }
+        TParticle* part = ev.stack.Particle(ii);
+        part->Set(pdg, mother, px, py, pz, sqrt(px*px+py*py+pz*pz+m*m));
+        part->SetPDG(pdg==22 ? &gNeutral : (pdg>0 ? &gPositive : &gNegative));
+        // secondaries are produced anywhere inside the detector [cm]
+        if (ii>=cfg.nPrimary) part->SetProductionVertex(300*gaus(rng), 300*gaus(rng), 300*gaus(rng));
+    }
+    for (Int_t ii=0; ii<nPart; ii++) {
+        Int_t mother = ev.stack.Particle(ii)->GetMother(0);
+        if (mother<0) continue;
+        TParticle* part = ev.stack.Particle(mother);
+        if (part->GetFirstDaughter()<0) part->SetDaughters(ii, ii);
+        else part->SetDaughters(part->GetFirstDaughter(), ii);
+    }
+
+    // tracks: status bits and labels
+    Int_t nTrk = nTracks(rng);
+    ev.status.Set(nTrk);
+    ev.labels.resize(nTrk);
+    ev.tracks.Clear();
+    for (Int_t ii=0; ii<nTrk; ii++) {
+        UInt_t status = (UInt_t)rng();
+        if (flat(rng)<cfg.passFraction) status = (status & ~cfg.TTmask) | cfg.TTpattern;
+        else if ((status & cfg.TTmask)==cfg.TTpattern) status ^= cfg.TTmask & (~cfg.TTmask+1);
+        ev.status[ii] = status;
+        ev.labels[ii] = (Int_t)(flat(rng)*nPart);
+        ev.tracks.Add(&ev.stack);       // any non-null object, never dereferenced
+    }
+
+    // the stages which use the truth index do not time its building
+    ev.truth.Build(&ev.stack);
+}
+
+// result of one stage
+struct BenchResult
+{
+    std::string name;
+    Long64_t    nEvents;
+    Double_t    ns;
+    Double_t    checksum;       // keeps the work from being optimised away
+};
+
+//_____________________________________________________________________________
+template <typename Stage>
+static BenchResult Run(const char* name, std::vector<BenchEvent>& pool, Long64_t nEvents, Stage stage)
+{
+    BenchResult res;
+    res.name = name;
+    res.nEvents = nEvents;
+    res.checksum = 0;
+    // one untimed pass over the pool to warm up caches and buffers
+    for (UInt_t ii=0; ii<pool.size(); ii++) stage(pool[ii]);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (Long64_t ii=0; ii<nEvents; ii++) res.checksum += stage(pool[ii % pool.size()]);
+    res.ns = std::chrono::duration<Double_t, std::nano>(std::chrono::steady_clock::now()-start).count();
+    return res;
+}
+
+//_____________________________________________________________________________
+static void Usage(const char* prog)
+{
+    fprintf(stderr, "usage: %s [--events N] [--pool N] [--occupancy P] [--tracks N]\n"
+        "       [--pass F] [--stack N] [--primaries N] [--seed S]\n", prog);
+}
+
+//_____________________________________________________________________________
+int main(int argc, char** argv)
+{
+    BenchConfig cfg;
+    cfg.nEvents      = 100000;
+    cfg.nPool        = 1000;
+    cfg.occupancy    = 0.01;
+    cfg.nTracks      = 10;
+    cfg.passFraction = 0.3;
+    cfg.nStack       = 500;
+    cfg.nPrimary     = 40;
+    cfg.seed         = 12345;
+    cfg.TTmask       = 0x1f;
+    cfg.TTpattern    = 0x1d;
+
+    for (Int_t ii=1; ii<argc; ii++) {
+        if (ii+1>=argc) { Usage(argv[0]); return 1; }
+        const char* opt = argv[ii];
+        const char* val = argv[++ii];
+        if      (!strcmp(opt, "--events"))    cfg.nEvents      = atoll(val);
+        else if (!strcmp(opt, "--pool"))      cfg.nPool        = atoi(val);
+        else if (!strcmp(opt, "--occupancy")) cfg.occupancy    = atof(val);
+        else if (!strcmp(opt, "--tracks"))    cfg.nTracks      = atoi(val);
+        else if (!strcmp(opt, "--pass"))      cfg.passFraction = atof(val);
+        else if (!strcmp(opt, "--stack"))     cfg.nStack       = atoi(val);
+        else if (!strcmp(opt, "--primaries")) cfg.nPrimary     = atoi(val);
+        else if (!strcmp(opt, "--seed"))      cfg.seed         = strtoul(val, 0, 0);
+        else { Usage(argv[0]); return 1; }
+    }
+    if (cfg.nEvents<1 || cfg.nPool<1 || cfg.nPrimary<5) { Usage(argv[0]); return 1; }
+
+    std::mt19937_64 rng(cfg.seed);
+    std::vector<BenchEvent> pool(cfg.nPool);
+    for (Int_t ii=0; ii<cfg.nPool; ii++) GenerateEvent(pool[ii], cfg, rng);
+
+    AliMCInfoEventBuffers buffers;
+    AliMCInfoTruthIndex truth(4096);
+    std::vector<BenchResult> results;
+
+    // one pass over the FastOR map gives the STG mask and the chip counts,
+    // as in AliAnalysisTaskMCInfo::EvaluateFastOR and IsSTGFired
+    results.push_back(Run("IsSTGFired", pool, cfg.nEvents, [](BenchEvent& ev) {
+        Short_t n0, n1;
+        UInt_t stgMask = AliMCInfoFastOR::Evaluate(&ev.foMap, n0, n1);
+        return (Double_t)AliMCInfoFastOR::IsSTGFired(stgMask, 2, 18) + n0 + n1;
+    }));
+    results.push_back(Run("Select", pool, cfg.nEvents, [&](BenchEvent& ev) {
+        buffers.Reset(&ev.status, &ev.tracks);
+        return (Double_t)buffers.Select(cfg.TTmask, cfg.TTpattern);
+    }));
+    results.push_back(Run("TruthIndex", pool, cfg.nEvents, [&](BenchEvent& ev) {
+        truth.Build(&ev.stack);
+        return (Double_t)truth.GetNChildren(0);
+    }));
+    // the matching and the X vector use the truth index built with the event
+    results.push_back(Run("TruthMatching", pool, cfg.nEvents, [&](BenchEvent& ev) {
+        buffers.Reset(&ev.status, &ev.tracks);
+        Int_t nSel = buffers.Select(cfg.TTmask, cfg.TTpattern);
+        TLorentzVector measured(0, 0, 0, 0), lv;
+        for (Int_t ii=0; ii<nSel; ii++) {
+            Int_t label = ev.labels[buffers.GetIndex(ii)];
+            if (!ev.truth.IsValid(label)) continue;
+            ev.truth.Momentum(label, lv);
+            measured += lv;
+        }
+        return measured.M();
+    }));
+    results.push_back(Run("XLorentzVector", pool, cfg.nEvents, [](BenchEvent& ev) {
+        TLorentzVector lv;
+        ev.truth.XMomentum(lv);
+        return lv.M();
+    }));
+
+    printf("{\n  \"config\": {\"events\": %lld, \"pool\": %d, \"occupancy\": %g, \"tracks\": %d, "
+        "\"pass\": %g, \"stack\": %d, \"primaries\": %d, \"seed\": %u},\n  \"stages\": [",
+        cfg.nEvents, cfg.nPool, cfg.occupancy, cfg.nTracks, cfg.passFraction,
+        cfg.nStack, cfg.nPrimary, cfg.seed);
+    for (UInt_t ii=0; ii<results.size(); ii++) {
+        const BenchResult& res = results[ii];
+        printf("%s\n    {\"name\": \"%s\", \"events\": %lld, \"ns_per_event\": %.2f, "
+            "\"events_per_s\": %.0f, \"checksum\": %.6g}",
+            ii ? "," : "", res.name.c_str(), res.nEvents, res.ns/res.nEvents,
+            res.ns>0 ? res.nEvents/res.ns*1e9 : 0., res.checksum);
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
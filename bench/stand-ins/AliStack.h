@@ -0,0 +1,26 @@
+// stand-in for AliStack, see bench/README.md
+#ifndef BENCH_AliStack_H
+#define BENCH_AliStack_H
+
+#include <vector>
+
+#include "TParticle.h"
+
+class AliStack : public TObject
+{
+    public:
+                            AliStack() : fNPrimary(0) {}
+
+        void                Reset(Int_t n, Int_t nPrimary) { fParticles.resize(n); fNPrimary = nPrimary; }
+        TParticle*          Particle(Int_t i)       { return &fParticles[i]; }
+
+        Int_t               GetNtrack() const       { return fParticles.size(); }
+        Int_t               GetNprimary() const     { return fNPrimary; }
+        Int_t               GetNtransported() const { return fParticles.size(); }
+
+    private:
+        std::vector<TParticle> fParticles;
+        Int_t               fNPrimary;
+};
+
+#endif
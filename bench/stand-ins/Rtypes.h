@@ -0,0 +1,27 @@
+// stand-in for the ROOT basic types, see bench/README.md
+#ifndef BENCH_Rtypes_H
+#define BENCH_Rtypes_H
+
+typedef char                Char_t;
+typedef unsigned char       UChar_t;
+typedef short               Short_t;
+typedef unsigned short      UShort_t;
+typedef int                 Int_t;
+typedef unsigned int        UInt_t;
+typedef long                Long_t;
+typedef unsigned long       ULong_t;
+typedef long long           Long64_t;
+typedef unsigned long long  ULong64_t;
+typedef float               Float_t;
+typedef double              Double_t;
+typedef bool                Bool_t;
+typedef const char          Option_t;
+
+const Bool_t kTRUE  = true;
+const Bool_t kFALSE = false;
+
+// no dictionaries without ROOT
+#define ClassDef(name, id)
+#define ClassImp(name)
+
+#endif
@@ -0,0 +1,25 @@
+// stand-in for TArrayI, see bench/README.md
+#ifndef BENCH_TArrayI_H
+#define BENCH_TArrayI_H
+
+#include <vector>
+
+#include "Rtypes.h"
+
+class TArrayI
+{
+    public:
+                            TArrayI(Int_t n=0) : fArray(n, 0) {}
+
+        void                Set(Int_t n)            { fArray.resize(n); }
+        Int_t               GetSize() const         { return fArray.size(); }
+        Int_t*              GetArray()              { return fArray.data(); }
+        const Int_t*        GetArray() const        { return fArray.data(); }
+        Int_t&              operator[](Int_t i)     { return fArray[i]; }
+        Int_t               At(Int_t i) const       { return fArray[i]; }
+
+    private:
+        std::vector<Int_t>  fArray;
+};
+
+#endif
@@ -0,0 +1,38 @@
+// stand-in for TBits with the interface used by AliMCInfoFastOR and the
+// same byte layout (bit i in byte i/8, at position i%8)
+#ifndef BENCH_TBits_H
+#define BENCH_TBits_H
+
+#include <cstring>
+#include <vector>
+
+#include "TObject.h"
+
+class TBits : public TObject
+{
+    public:
+                            TBits(UInt_t nbits=8) : fNbits(nbits), fBytes((nbits+7)/8, 0) {}
+
+        void                ResetAllBits()          { std::memset(fBytes.data(), 0, fBytes.size()); }
+        void                SetBitNumber(UInt_t i)  { fBytes[i>>3] |= 1 << (i & 7); }
+        Bool_t              TestBitNumber(UInt_t i) const
+                                { return i<fNbits && (fBytes[i>>3] >> (i & 7)) & 1; }
+        Bool_t              operator[](UInt_t i) const { return TestBitNumber(i); }
+        UInt_t              GetNbits() const        { return fNbits; }
+        UInt_t              GetNbytes() const       { return fBytes.size(); }
+        void                Get(UChar_t* array) const
+                                { std::memcpy(array, fBytes.data(), fBytes.size()); }
+        UInt_t              FirstSetBit(UInt_t start=0) const
+                                { for (UInt_t i=start; i<fNbits; i++) if (TestBitNumber(i)) return i;
+                                  return fNbits; }
+        UInt_t              CountBits(UInt_t start=0) const
+                                { UInt_t n = 0;
+                                  for (UInt_t i=start; i<fNbits; i++) n += TestBitNumber(i);
+                                  return n; }
+
+    private:
+        UInt_t              fNbits;
+        std::vector<UChar_t> fBytes;
+};
+
+#endif
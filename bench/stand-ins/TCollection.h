@@ -0,0 +1,45 @@
+// stand-in for TCollection and TIter (non-owning by default), see bench/README.md
+#ifndef BENCH_TCollection_H
+#define BENCH_TCollection_H
+
+#include <cstring>
+#include <vector>
+
+#include "TObject.h"
+
+class TCollection : public TObject
+{
+    public:
+                            TCollection() : fOwner(kFALSE) {}
+        virtual            ~TCollection()               { if (fOwner) for (UInt_t ii=0; ii<fCont.size(); ii++) delete fCont[ii]; }
+        void                Add(TObject* obj)           { fCont.push_back(obj); }
+        void                SetOwner(Bool_t owner=kTRUE) { fOwner = owner; }
+        Int_t               GetEntries() const          { return fCont.size(); }
+        TObject*            At(Int_t i) const           { return fCont[i]; }
+        TObject*            FindObject(const char* name) const
+        {
+            for (UInt_t ii=0; ii<fCont.size(); ii++)
+                if (!strcmp(fCont[ii]->GetName(), name)) return fCont[ii];
+            return 0;
+        }
+
+    private:
+        std::vector<TObject*> fCont;
+        Bool_t              fOwner;
+
+        TCollection(const TCollection&);
+        TCollection& operator=(const TCollection&);
+};
+
+class TIter
+{
+    public:
+                            TIter(const TCollection* coll) : fColl(coll), fPos(0) {}
+        TObject*            operator()()                { return fPos<fColl->GetEntries() ? fColl->At(fPos++) : 0; }
+
+    private:
+        const TCollection*  fColl;
+        Int_t               fPos;
+};
+
+#endif
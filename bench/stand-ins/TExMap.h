@@ -0,0 +1,47 @@
+// stand-in for TExMap and TExMapIter, see bench/README.md
+#ifndef BENCH_TExMap_H
+#define BENCH_TExMap_H
+
+#include <map>
+
+#include "TObject.h"
+
+// as in ROOT, GetSize is the size of the table and GetEntries the number
+// of keys; the hash is not used, the iteration is ordered by key
+class TExMap : public TObject
+{
+    friend class TExMapIter;
+    public:
+        Long64_t&           operator()(ULong64_t, Long64_t key) { return fMap[key]; }
+        Long64_t            GetValue(ULong64_t, Long64_t key)
+        {
+            std::map<Long64_t, Long64_t>::const_iterator it = fMap.find(key);
+            return it==fMap.end() ? 0 : it->second;
+        }
+        Int_t               GetEntries() const          { return fMap.size(); }
+        Int_t               GetSize() const             { Int_t n = 16; while (n<2*GetEntries()) n *= 2; return n; }
+        void                Delete(Option_t* = "")      { fMap.clear(); }
+
+    private:
+        std::map<Long64_t, Long64_t> fMap;
+};
+
+class TExMapIter
+{
+    public:
+                            TExMapIter(const TExMap* map) : fMap(map), fIt(map->fMap.begin()) {}
+        Bool_t              Next(Long64_t& key, Long64_t& value)
+        {
+            if (fIt==fMap->fMap.end()) return kFALSE;
+            key = fIt->first;
+            value = fIt->second;
+            ++fIt;
+            return kTRUE;
+        }
+
+    private:
+        const TExMap*       fMap;
+        std::map<Long64_t, Long64_t>::const_iterator fIt;
+};
+
+#endif
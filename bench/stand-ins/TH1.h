@@ -0,0 +1,59 @@
+// stand-in for TH1 and TAxis with fixed bins, see bench/README.md
+#ifndef BENCH_TH1_H
+#define BENCH_TH1_H
+
+#include <string>
+#include <vector>
+
+#include "TNamed.h"
+
+class TAxis
+{
+    public:
+                            TAxis(Int_t nbins) : fLabels(nbins+2) {}
+        void                SetBinLabel(Int_t bin, const char* label) { fLabels[bin] = label; }
+        const char*         GetBinLabel(Int_t bin) const { return fLabels[bin].c_str(); }
+
+    private:
+        std::vector<std::string> fLabels;
+};
+
+class TH1 : public TNamed
+{
+    public:
+                            TH1(const char* name, const char* title, Int_t nbins, Double_t xmin, Double_t xmax)
+                              : TNamed(name, title), fNbins(nbins), fXmin(xmin), fXmax(xmax)
+                              , fBins(nbins+2, 0.), fEntries(0.), fXaxis(nbins) {}
+        void                SetDirectory(void*)         {}
+        Int_t               GetNbinsX() const           { return fNbins; }
+        TAxis*              GetXaxis()                  { return &fXaxis; }
+        Int_t               FindBin(Double_t x) const
+        {
+            if (x<fXmin) return 0;
+            if (!(x<fXmax)) return fNbins+1;
+            return 1 + Int_t(fNbins*(x-fXmin)/(fXmax-fXmin));
+        }
+        Int_t               Fill(Double_t x)            { Int_t bin = FindBin(x); fBins[bin]++; fEntries++; return bin; }
+        void                AddBinContent(Int_t bin, Double_t w) { fBins[bin] += w; }
+        void                SetBinContent(Int_t bin, Double_t w) { fBins[bin] = w; fEntries++; }
+        Double_t            GetBinContent(Int_t bin) const { return fBins[bin]; }
+        Double_t            GetEntries() const          { return fEntries; }
+        void                SetEntries(Double_t n)      { fEntries = n; }
+        // as in ROOT for unweighted histograms: the entries become the sum
+        // of the contents of the bins in range
+        void                ResetStats()
+        {
+            fEntries = 0;
+            for (Int_t bin=1; bin<=fNbins; bin++) fEntries += fBins[bin];
+        }
+
+    protected:
+        Int_t               fNbins;
+        Double_t            fXmin;
+        Double_t            fXmax;
+        std::vector<Double_t> fBins;
+        Double_t            fEntries;
+        TAxis               fXaxis;
+};
+
+#endif
@@ -0,0 +1,15 @@
+// stand-in for TH1D, see bench/README.md
+#ifndef BENCH_TH1D_H
+#define BENCH_TH1D_H
+
+#include "TH1.h"
+
+class TH1D : public TH1
+{
+    public:
+                            TH1D(const char* name, const char* title, Int_t nbins, Double_t xmin, Double_t xmax)
+                              : TH1(name, title, nbins, xmin, xmax) {}
+        virtual const char* ClassName() const           { return "TH1D"; }
+};
+
+#endif
@@ -0,0 +1,19 @@
+// stand-in for TList, see bench/README.md
+#ifndef BENCH_TList_H
+#define BENCH_TList_H
+
+#include "TCollection.h"
+#include "TString.h"
+
+class TList : public TCollection
+{
+    public:
+        virtual const char* GetName() const             { return fName.Data(); }
+        virtual const char* ClassName() const           { return "TList"; }
+        void                SetName(const char* name)   { fName = name; }
+
+    private:
+        TString             fName;
+};
+
+#endif
@@ -0,0 +1,31 @@
+// stand-in for TLorentzVector, see bench/README.md
+#ifndef BENCH_TLorentzVector_H
+#define BENCH_TLorentzVector_H
+
+#include <cmath>
+
+#include "TObject.h"
+
+class TLorentzVector : public TObject
+{
+    public:
+                            TLorentzVector(Double_t px=0, Double_t py=0, Double_t pz=0, Double_t e=0)
+                              : fPx(px), fPy(py), fPz(pz), fE(e) {}
+
+        void                SetPxPyPzE(Double_t px, Double_t py, Double_t pz, Double_t e)
+                                { fPx = px; fPy = py; fPz = pz; fE = e; }
+        Double_t            Px() const              { return fPx; }
+        Double_t            Py() const              { return fPy; }
+        Double_t            Pz() const              { return fPz; }
+        Double_t            E() const               { return fE; }
+        Double_t            M2() const              { return fE*fE - fPx*fPx - fPy*fPy - fPz*fPz; }
+        Double_t            M() const
+                                { Double_t mm = M2(); return mm<0 ? -std::sqrt(-mm) : std::sqrt(mm); }
+        TLorentzVector&     operator+=(const TLorentzVector& lv)
+                                { fPx += lv.fPx; fPy += lv.fPy; fPz += lv.fPz; fE += lv.fE; return *this; }
+
+    private:
+        Double_t            fPx, fPy, fPz, fE;
+};
+
+#endif
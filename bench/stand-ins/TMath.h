@@ -0,0 +1,14 @@
+// stand-in for TMath, see bench/README.md
+#ifndef BENCH_TMath_H
+#define BENCH_TMath_H
+
+#include <cmath>
+
+#include "Rtypes.h"
+
+namespace TMath
+{
+    inline Double_t Sqrt(Double_t x) { return std::sqrt(x); }
+}
+
+#endif
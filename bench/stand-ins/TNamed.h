@@ -0,0 +1,23 @@
+// stand-in for TNamed, see bench/README.md
+#ifndef BENCH_TNamed_H
+#define BENCH_TNamed_H
+
+#include "TObject.h"
+#include "TString.h"
+
+class TNamed : public TObject
+{
+    public:
+                            TNamed() {}
+                            TNamed(const char* name, const char* title) : fName(name), fTitle(title) {}
+        virtual const char* GetName() const             { return fName.Data(); }
+        virtual const char* GetTitle() const            { return fTitle.Data(); }
+        virtual const char* ClassName() const           { return "TNamed"; }
+        void                SetName(const char* name)   { fName = name; }
+
+    private:
+        TString             fName;
+        TString             fTitle;
+};
+
+#endif
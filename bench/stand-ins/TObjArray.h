@@ -0,0 +1,23 @@
+// stand-in for TObjArray (non-owning), see bench/README.md
+#ifndef BENCH_TObjArray_H
+#define BENCH_TObjArray_H
+
+#include <vector>
+
+#include "TObject.h"
+
+class TObjArray : public TObject
+{
+    public:
+        void                Add(TObject* obj)       { fCont.push_back(obj); }
+        void                Clear()                 { fCont.clear(); }
+        Int_t               GetEntriesFast() const  { return fCont.size(); }
+        Int_t               GetSize() const         { return fCont.capacity(); }
+        TObject*            At(Int_t i) const       { return fCont[i]; }
+        TObject**           GetObjectRef() const    { return const_cast<TObject**>(fCont.data()); }
+
+    private:
+        std::vector<TObject*> fCont;
+};
+
+#endif
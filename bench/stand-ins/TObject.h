@@ -0,0 +1,19 @@
+// stand-in for TObject, see bench/README.md
+#ifndef BENCH_TObject_H
+#define BENCH_TObject_H
+
+#include <cstdio>
+
+#include "Rtypes.h"
+
+class TObject
+{
+    public:
+        virtual            ~TObject() {}
+        virtual const char* GetName() const             { return ClassName(); }
+        virtual const char* ClassName() const           { return "TObject"; }
+        virtual void        Clear(Option_t* = "")       {}
+        virtual void        Print(Option_t* = "") const {}
+};
+
+#endif
@@ -0,0 +1,55 @@
+// stand-in for TParticle, see bench/README.md
+#ifndef BENCH_TParticle_H
+#define BENCH_TParticle_H
+
+#include "TObject.h"
+
+// charge in units of |e|/3 as in the particle database
+class TParticlePDG
+{
+    public:
+                            TParticlePDG(Double_t charge=0) : fCharge(charge) {}
+        Double_t            Charge() const          { return fCharge; }
+
+    private:
+        Double_t            fCharge;
+};
+
+class TParticle : public TObject
+{
+    public:
+                            TParticle() : fPdg(0), fPDG(0), fPx(0), fPy(0), fPz(0), fE(0), fVx(0), fVy(0), fVz(0)
+                                { fMother[0] = fMother[1] = fDaughter[0] = fDaughter[1] = -1; }
+
+        void                Set(Int_t pdg, Int_t mother, Double_t px, Double_t py, Double_t pz, Double_t e)
+                                { fPdg = pdg; fMother[0] = mother; fPx = px; fPy = py; fPz = pz; fE = e;
+                                  fDaughter[0] = fDaughter[1] = -1; }
+        void                SetDaughters(Int_t first, Int_t last) { fDaughter[0] = first; fDaughter[1] = last; }
+        void                SetProductionVertex(Double_t vx, Double_t vy, Double_t vz)
+                                { fVx = vx; fVy = vy; fVz = vz; }
+        // the database entry, the stand-in knows the charge of the pdg code
+        void                SetPDG(TParticlePDG* pdg) { fPDG = pdg; }
+
+        Int_t               GetPdgCode() const      { return fPdg; }
+        TParticlePDG*       GetPDG() const          { return fPDG; }
+        Int_t               GetMother(Int_t i) const { return fMother[i]; }
+        Int_t               GetFirstDaughter() const { return fDaughter[0]; }
+        Int_t               GetLastDaughter() const { return fDaughter[1]; }
+        Double_t            Px() const              { return fPx; }
+        Double_t            Py() const              { return fPy; }
+        Double_t            Pz() const              { return fPz; }
+        Double_t            Energy() const          { return fE; }
+        Double_t            Vx() const              { return fVx; }
+        Double_t            Vy() const              { return fVy; }
+        Double_t            Vz() const              { return fVz; }
+
+    private:
+        Int_t               fPdg;
+        Int_t               fMother[2];
+        Int_t               fDaughter[2];
+        TParticlePDG*       fPDG;
+        Double_t            fPx, fPy, fPz, fE;
+        Double_t            fVx, fVy, fVz;
+};
+
+#endif
@@ -0,0 +1,7 @@
+// stand-in for TParticlePDG, defined with TParticle, see bench/README.md
+#ifndef BENCH_TParticlePDG_H
+#define BENCH_TParticlePDG_H
+
+#include "TParticle.h"
+
+#endif
@@ -0,0 +1,34 @@
+// stand-in for TString and Form, see bench/README.md
+#ifndef BENCH_TString_H
+#define BENCH_TString_H
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+#include "Rtypes.h"
+
+class TString
+{
+    public:
+                            TString() {}
+                            TString(const char* s) : fStr(s ? s : "") {}
+        const char*         Data() const                { return fStr.c_str(); }
+        Bool_t              IsNull() const              { return fStr.empty(); }
+
+    private:
+        std::string         fStr;
+};
+
+// not thread-safe, like the ROOT version with its circular buffer
+inline char* Form(const char* fmt, ...)
+{
+    static char buf[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+#endif
@@ -0,0 +1,158 @@
+// equivalence test of AliMCInfoFastOR against the sector-loop reference
+//
+//   g++ -O2 -std=c++11 -Istand-ins -I.. testFastOR.cxx -o testFastOR
+//   ./testFastOR [nMaps]
+//
+// exhaustive part: every pair of inner sectors with every subset of the
+// outer sectors which can confirm them, and every single chip of each layer
+// against a full other layer; per map the STG decision of every sector
+// distance and the fired chips are compared. randomized part (nMaps maps):
+// chip-level and sector-level occupancies from sparse to full and maps
+// with bits beyond the last chip, compared for every range
+// dphiMin..dphiMax (0..kMaxD). the exit code is the number of mismatching
+// maps
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "TBits.h"
+#include "AliMCInfoFastOR.h"
+#include "FastORReference.h"
+
+const Int_t kMaxD = 2*AliMCInfoFastOR::kNSectL0 + 1;    // also beyond one turn
+
+//_____________________________________________________________________________
+static Int_t Compare(const TBits& foMap, Long64_t& nChecks)
+{
+    Short_t n0, n1, ref0, ref1;
+    UInt_t stgMask = AliMCInfoFastOR::Evaluate(&foMap, n0, n1);
+    ReferenceFiredChips(foMap, ref0, ref1);
+    Int_t nBad = 0;
+    if (n0!=ref0 || n1!=ref1) {
+        printf("<E> fired chips %i %i instead of %i %i\n", n0, n1, ref0, ref1);
+        nBad++;
+    }
+    for (Int_t dphiMin=0; dphiMin<=kMaxD; dphiMin++) {
+        for (Int_t dphiMax=dphiMin; dphiMax<=kMaxD; dphiMax++) {
+            nChecks++;
+            Bool_t fired = AliMCInfoFastOR::IsSTGFired(stgMask, dphiMin, dphiMax);
+            if (fired==ReferenceIsSTGFired(&foMap, dphiMin, dphiMax)) continue;
+            printf("<E> STG %i instead of %i for dphi %i..%i\n", fired, !fired, dphiMin, dphiMax);
+            nBad++;
+        }
+    }
+    return nBad;
+}
+
+//_____________________________________________________________________________
+static Int_t CompareDistances(const TBits& foMap, Long64_t& nChecks)
+{
+    // every distance 0..kNSectL0-1 on its own: the reference repeats with
+    // the period kNSectL0, the ranges are covered by Compare
+    Short_t n0, n1, ref0, ref1;
+    UInt_t stgMask = AliMCInfoFastOR::Evaluate(&foMap, n0, n1);
+    ReferenceFiredChips(foMap, ref0, ref1);
+    Int_t nBad = 0;
+    if (n0!=ref0 || n1!=ref1) {
+        printf("<E> fired chips %i %i instead of %i %i\n", n0, n1, ref0, ref1);
+        nBad++;
+    }
+    for (Int_t dphi=0; dphi<AliMCInfoFastOR::kNSectL0; dphi++) {
+        nChecks++;
+        Bool_t fired = AliMCInfoFastOR::IsSTGFired(stgMask, dphi, dphi);
+        if (fired==ReferenceIsSTGFired(&foMap, dphi, dphi)) continue;
+        printf("<E> STG %i instead of %i for dphi %i\n", fired, !fired, dphi);
+        nBad++;
+    }
+    return nBad;
+}
+
+//_____________________________________________________________________________
+int main(int argc, char** argv)
+{
+    Int_t nMaps = argc>1 ? atoi(argv[1]) : 1000;
+    std::mt19937_64 rng(4711);
+    std::uniform_real_distribution<Double_t> flat(0., 1.);
+    const Int_t nChips = AliMCInfoFastOR::kNChips;
+    const Int_t nPerSect = AliMCInfoFastOR::kChipsPerSect;
+
+    Int_t nFailed = 0;
+    Long64_t nChecks = 0, nMapsTested = 0;
+    TBits foMap(nChips);
+
+    // empty map, one layer only, full map
+    nFailed += Compare(foMap, nChecks) > 0; nMapsTested++;
+    foMap.SetBitNumber(17);
+    nFailed += Compare(foMap, nChecks) > 0; nMapsTested++;
+    foMap.ResetAllBits();
+    foMap.SetBitNumber(1000);
+    nFailed += Compare(foMap, nChecks) > 0; nMapsTested++;
+    for (Int_t ii=0; ii<nChips; ii++) foMap.SetBitNumber(ii);
+    nFailed += Compare(foMap, nChecks) > 0; nMapsTested++;
+
+    // exhaustive: every pair of fired inner sectors (also twice the same)
+    // with every subset of the outer sectors 2s-1..2s+2 of both. the STG
+    // decision depends only on these sectors; the fired chip inside a sector
+    // moves with the map, so that sectors straddling two words are reached
+    const Int_t nSectL0 = AliMCInfoFastOR::kNSectL0;
+    const Int_t nSectL1 = AliMCInfoFastOR::kNSectL1;
+    Int_t nChip = 0;
+    for (Int_t s0=0; s0<nSectL0; s0++) {
+        for (Int_t s1=s0; s1<nSectL0; s1++) {
+            // the distinct outer neighbours of both inner sectors
+            Int_t outer[8], nOuter = 0;
+            for (Int_t jj=0; jj<8; jj++) {
+                Int_t o = (2*(jj<4 ? s0 : s1) + jj%4 - 1 + nSectL1) % nSectL1;
+                Int_t kk = 0;
+                while (kk<nOuter && outer[kk]!=o) kk++;
+                if (kk==nOuter) outer[nOuter++] = o;
+            }
+            for (Int_t subset=0; subset<(1<<nOuter); subset++) {
+                foMap.ResetAllBits();
+                foMap.SetBitNumber(s0*nPerSect + nChip++%nPerSect);
+                foMap.SetBitNumber(s1*nPerSect + nChip++%nPerSect);
+                for (Int_t kk=0; kk<nOuter; kk++) {
+                    if (!(subset & (1<<kk))) continue;
+                    foMap.SetBitNumber(AliMCInfoFastOR::kNChipsL0 + outer[kk]*nPerSect + nChip++%nPerSect);
+                }
+                nFailed += CompareDistances(foMap, nChecks) > 0; nMapsTested++;
+            }
+        }
+    }
+
+    // exhaustive: every single chip of one layer against a full other layer
+    for (Int_t chip=0; chip<nChips; chip++) {
+        foMap.ResetAllBits();
+        Bool_t inner = chip<AliMCInfoFastOR::kNChipsL0;
+        for (Int_t ii=inner ? AliMCInfoFastOR::kNChipsL0 : 0;
+             ii<(inner ? nChips : AliMCInfoFastOR::kNChipsL0); ii++) foMap.SetBitNumber(ii);
+        foMap.SetBitNumber(chip);
+        nFailed += CompareDistances(foMap, nChecks) > 0; nMapsTested++;
+    }
+
+    // random maps: chip-level occupancy, sector-level occupancy
+    for (Int_t imap=0; imap<nMaps; imap++) {
+        foMap.ResetAllBits();
+        if (imap%2) {
+            Double_t occupancy = imap%10==1 ? 0.5 : 0.02*flat(rng);
+            for (Int_t ii=0; ii<nChips; ii++) if (flat(rng)<occupancy) foMap.SetBitNumber(ii);
+        } else {
+            Double_t occupancy = 0.3*flat(rng);
+            for (Int_t sect=0; sect<nChips/nPerSect; sect++)
+                if (flat(rng)<occupancy) foMap.SetBitNumber(sect*nPerSect + (Int_t)(flat(rng)*nPerSect));
+        }
+        nFailed += Compare(foMap, nChecks) > 0; nMapsTested++;
+    }
+
+    // bits beyond the last chip count to the outer layer of the reference
+    for (Int_t imap=0; imap<nMaps/10; imap++) {
+        TBits bigMap(nChips + 100);
+        for (Int_t ii=0; ii<nChips+100; ii++) if (flat(rng)<0.01) bigMap.SetBitNumber(ii);
+        if (imap%2) bigMap.SetBitNumber(nChips + (Int_t)(flat(rng)*100));
+        nFailed += Compare(bigMap, nChecks) > 0; nMapsTested++;
+    }
+
+    printf("%lld maps, %lld STG decisions compared, %i maps with mismatches\n",
+        nMapsTested, nChecks, nFailed);
+    return nFailed;
+}
@@ -0,0 +1,180 @@
+// concurrency test of AliMCInfoHistShards, histograms and pdg counters
+//
+//   g++ -O2 -std=c++11 -pthread -Istand-ins -I.. testHistShards.cxx ../AliMCInfoPDGCounter.cxx -o testHistShards
+//   ./testHistShards [nThreads] [nFills]
+//
+// nThreads threads (default 8) fill the same histogram and as many threads
+// the same pdg counter, through shards for half of nThreads threads, so that
+// the shards and the overflow are both used. every thread fills its own reproducible sequence of values,
+// in range, underflow and overflow, with unit and integer weights. after
+// two rounds of filling and flushing, every bin has to agree exactly with
+// a histogram filled serially with the same sequences; contents already in
+// the output histogram (a restored checkpoint) have to be kept. the pdg
+// counters are filled the same way with codes from a few frequent ones to
+// rare nuclei and compared code by code. the exit code is the number of
+// mismatching bins and codes. built with -fsanitize=thread, the test also
+// checks Fill and FillCounter for data races
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "TH1F.h"
+#include "TList.h"
+#include "AliMCInfoHistShards.h"
+
+const Int_t kNbins = 100;
+const Double_t kXmin = 0.;
+const Double_t kXmax = 10.;
+
+//_____________________________________________________________________________
+// the values, weights and pdg codes filled by thread it in round iround
+struct Sequence {
+    std::mt19937_64 fRng;
+    std::uniform_real_distribution<Double_t> fX;
+    Sequence(Int_t it, Int_t iround) : fRng(1000*iround + it), fX(kXmin-1., kXmax+1.) {}
+    Double_t X() { return fX(fRng); }
+    ULong64_t W() { return fRng()%4==0 ? 1 + fRng()%5 : 1; }
+    // frequent codes, both signs, and rare nuclei
+    Int_t Pdg()
+    {
+        static const Int_t codes[] = { 22, 111, 211, -211, 2112, -2112, 130, 310 };
+        if (fRng()%100==0) return 1000000000 + 10*(Int_t)(fRng()%300);
+        return codes[fRng()%8];
+    }
+};
+
+//_____________________________________________________________________________
+static void FillThread(AliMCInfoHistShards* hists, Int_t id, Int_t it, Int_t iround, Int_t nFills)
+{
+    Sequence seq(it, iround);
+    for (Int_t ii=0; ii<nFills; ii++) {
+        Double_t x = seq.X();
+        ULong64_t w = seq.W();
+        if (w==1) hists->Fill(id, x);
+        else hists->Fill(id, x, w);
+    }
+}
+
+//_____________________________________________________________________________
+static void FillCounterThread(AliMCInfoHistShards* hists, Int_t id, Int_t it, Int_t iround, Int_t nFills)
+{
+    Sequence seq(it, iround);
+    for (Int_t ii=0; ii<nFills; ii++) hists->FillCounter(id, seq.Pdg());
+}
+
+//_____________________________________________________________________________
+static void FillCounterSerial(std::map<Int_t, Long64_t>& ref, Int_t it, Int_t iround, Int_t nFills)
+{
+    Sequence seq(it, iround);
+    for (Int_t ii=0; ii<nFills; ii++) ref[seq.Pdg()]++;
+}
+
+//_____________________________________________________________________________
+static void FillSerial(TH1F* ref, Int_t it, Int_t iround, Int_t nFills)
+{
+    Sequence seq(it, iround);
+    for (Int_t ii=0; ii<nFills; ii++) {
+        Double_t x = seq.X();
+        ULong64_t w = seq.W();
+        ref->AddBinContent(ref->FindBin(x), w);
+    }
+}
+
+//_____________________________________________________________________________
+static Int_t Compare(TH1F* hist, TH1F* ref, Int_t iround)
+{
+    Int_t nBad = 0;
+    Double_t inRange = 0;
+    for (Int_t bin=0; bin<=kNbins+1; bin++) {
+        if (bin>=1 && bin<=kNbins) inRange += ref->GetBinContent(bin);
+        if (hist->GetBinContent(bin)==ref->GetBinContent(bin)) continue;
+        printf("<E> round %i, bin %i: %.0f instead of %.0f\n",
+            iround, bin, hist->GetBinContent(bin), ref->GetBinContent(bin));
+        nBad++;
+    }
+    // the statistics are recomputed from the merged contents
+    if (hist->GetEntries()!=inRange) {
+        printf("<E> round %i: %.0f entries instead of %.0f\n", iround, hist->GetEntries(), inRange);
+        nBad++;
+    }
+    return nBad;
+}
+
+//_____________________________________________________________________________
+static Int_t CompareCounter(AliMCInfoPDGCounter* counter, const std::map<Int_t, Long64_t>& ref, Int_t iround)
+{
+    Int_t nBad = 0;
+    Long64_t entries = 0;
+    for (std::map<Int_t, Long64_t>::const_iterator it=ref.begin(); it!=ref.end(); ++it) {
+        entries += it->second;
+        if (counter->GetCount(it->first)==it->second) continue;
+        printf("<E> round %i, pdg %i: %lld instead of %lld\n",
+            iround, it->first, counter->GetCount(it->first), it->second);
+        nBad++;
+    }
+    if (counter->GetNCodes()!=(Int_t)ref.size() || counter->GetEntries()!=entries) {
+        printf("<E> round %i: %i codes, %lld entries instead of %i, %lld\n", iround,
+            counter->GetNCodes(), counter->GetEntries(), (Int_t)ref.size(), entries);
+        nBad++;
+    }
+    return nBad;
+}
+
+//_____________________________________________________________________________
+int main(int argc, char** argv)
+{
+    Int_t nThreads = argc>1 ? atoi(argv[1]) : 8;
+    Int_t nFills = argc>2 ? atoi(argv[2]) : 200000;
+    if (nThreads<2) nThreads = 2;
+
+    TList list;
+    list.SetOwner(kTRUE);
+    AliMCInfoHistShards hists(nThreads/2);
+    Int_t id = hists.Book(&list, "fTest", "fTest", kNbins, kXmin, kXmax);
+    TH1F* hist = hists.GetHistogram(id);
+    TH1F ref("fRef", "fRef", kNbins, kXmin, kXmax);
+    Int_t cid = hists.BookCounter(&list, "fTestPDG", "fTestPDG");
+    AliMCInfoPDGCounter* counter = hists.GetCounter(cid);
+    std::map<Int_t, Long64_t> refCounts;
+    Int_t nFailed = 0;
+    if (list.FindObject("fTest")!=hist || list.FindObject("fTestPDG")!=counter) {
+        printf("<E> histogram or counter not added to the list\n");
+        nFailed++;
+    }
+
+    // restored contents
+    hist->SetBinContent(17, 42);
+    ref.SetBinContent(17, 42);
+    counter->Fill(211, 42);
+    refCounts[211] += 42;
+
+    // the threads are started anew in the second round and get new thread
+    // numbers, i.e. no shard: all of their fills go to the overflow
+    for (Int_t iround=0; iround<2; iround++) {
+        std::vector<std::thread> threads;
+        for (Int_t it=0; it<nThreads; it++) {
+            threads.push_back(std::thread(FillThread, &hists, id, it, iround, nFills));
+            threads.push_back(std::thread(FillCounterThread, &hists, cid, it, iround, nFills/10));
+        }
+        for (UInt_t it=0; it<threads.size(); it++) threads[it].join();
+        hists.Flush();
+        for (Int_t it=0; it<nThreads; it++) {
+            FillSerial(&ref, it, iround, nFills);
+            FillCounterSerial(refCounts, it, iround, nFills/10);
+        }
+        nFailed += Compare(hist, &ref, iround);
+        nFailed += CompareCounter(counter, refCounts, iround);
+    }
+
+    // a flush without fills leaves the histogram and the counter as they are
+    hists.Flush();
+    nFailed += Compare(hist, &ref, 2);
+    nFailed += CompareCounter(counter, refCounts, 2);
+
+    printf("%i threads, %i fills per thread and round, %i mismatches\n",
+        nThreads, nFills, nFailed);
+    return nFailed;
+}